@@ -0,0 +1,78 @@
+#ifndef OneAPI_Homework_my_fft_hpp
+#define OneAPI_Homework_my_fft_hpp
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "my.hpp"
+
+namespace my {
+
+    // 复数以 sycl::float2 表示：[0] 为实部，[1] 为虚部
+    inline sycl::float2 complex_mul(sycl::float2 a, sycl::float2 b) {
+        return sycl::float2(a[0] * b[0] - a[1] * b[1], a[0] * b[1] + a[1] * b[0]);
+    }
+
+    // exp(2πi turns)
+    inline sycl::float2 twiddle(float turns) {
+        const float angle = 2.0f * float(M_PI) * turns;
+        return sycl::float2(sycl::cos(angle), sycl::sin(angle));
+    }
+
+    // 通用基的最大值：更大的素因子要求 O(radix^2) 的蝶形运算和更多的寄存器
+    constexpr int fft_max_radix = 7;
+
+    // 原地计算长度为 radix 的 DFT：v[q] = Σ_p v[p] exp(direction 2πi pq / radix)，
+    // direction 为 -1（正变换）或 1（逆变换，不含 1/n 的缩放）
+    // hint: 基 2、基 4 只需加减和乘以 ±i，其余的基直接按定义计算
+    inline void fft_butterfly(sycl::float2 *v, int radix, float direction) {
+        if (radix == 2) {
+            auto t = v[0] - v[1];
+            v[0] = v[0] + v[1];
+            v[1] = t;
+        } else if (radix == 4) {
+            auto t0 = v[0] + v[2], t1 = v[0] - v[2], t2 = v[1] + v[3], t3 = v[1] - v[3];
+            sycl::float2 rotated(-direction * t3[1], direction * t3[0]);     // direction · i · t3
+            v[0] = t0 + t2, v[1] = t1 + rotated, v[2] = t0 - t2, v[3] = t1 - rotated;
+        } else {
+            sycl::float2 t[fft_max_radix];
+            for (int q = 0; q < radix; q++) {
+                t[q] = v[0];
+                for (int p = 1; p < radix; p++)
+                    t[q] += complex_mul(v[p], twiddle(direction * float(p * q % radix) / radix));
+            }
+            for (int q = 0; q < radix; q++) v[q] = t[q];
+        }
+    }
+
+    // 长度为 size 的混合基 FFT 的分解：优先使用基 4，其次基 2，其余因子按素数逐个作为通用基
+    // 各级按 radices 的顺序执行，第 s 级的 span 为前 s 级的基之积（Stockham 自动排序，输出为自然顺序）
+    struct fft_plan {
+        int size;
+        std::vector<int> radices;
+
+        explicit fft_plan(int size) : size(size) {
+            int n = size;
+            for (int radix : {4, 2})
+                while (n % radix == 0) radices.push_back(radix), n /= radix;
+            for (int radix = 3; radix <= fft_max_radix; radix += 2)
+                while (n % radix == 0) radices.push_back(radix), n /= radix;
+            if (n != 1)
+                throw std::runtime_error("FFT size " + std::to_string(size) + " has a prime factor larger than " +
+                                         std::to_string(fft_max_radix));
+        }
+    };
+
+    // 不小于 n 且只含因子 2、3、5 的最小长度，补齐的零比取 2 的幂少，各级仍是小基
+    inline int fft_size(int n) {
+        for (int m = std::max(n, 1);; m++) {
+            int r = m;
+            for (int p : {2, 3, 5})
+                while (r % p == 0) r /= p;
+            if (r == 1) return m;
+        }
+    }
+}
+
+#endif /* OneAPI_Homework_my_fft_hpp */
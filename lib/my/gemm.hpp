@@ -0,0 +1,167 @@
+#ifndef OneAPI_Homework_my_gemm_hpp
+#define OneAPI_Homework_my_gemm_hpp
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace my {
+
+    // GEMM 操作数的形式：n 表示原矩阵，t 表示使用其转置；转置在读取时完成，不会生成转置后的副本
+    enum class op { n, t };
+
+    // 实际使用的 host 线程数；threads 不大于 0 时使用全部硬件线程
+    inline int host_threads(int threads = 0) {
+        if (threads > 0) return threads;
+        return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    // Host 端多线程执行 [0, count) 内的任务，任务按线程号交错分配
+    template <typename F>
+    void host_parallel_for(int count, int threads, F &&f) {
+        threads = std::min(host_threads(threads), count);
+        if (threads <= 1) {
+            for (int i = 0; i < count; i++) f(i);
+            return;
+        }
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (int t = 0; t < threads; t++)
+            workers.emplace_back([&, t] {
+                for (int i = t; i < count; i += threads) f(i);
+            });
+        for (auto &worker : workers) worker.join();
+    }
+
+    namespace gemm_detail {
+
+        // 分块参数：kc x nr 的 B 条带驻留 L1，mc x kc 的 A 块驻留 L2，kc x nc 的 B 面板驻留 L3
+        template <typename T>
+        struct blocking {
+            static constexpr int mr = 6;
+            static constexpr int nr = std::max<int>(1, 64 / sizeof(T));
+            static constexpr int kc = 256;
+            static constexpr int mc = mr * 16;
+            static constexpr int nc = nr * 128;
+        };
+
+        // 把 op(A) 的 mc x kc 块按 mr 行一条打包为 [条][k][mr]，不足的行补 0
+        // a 指向 op(A) 中块的左上角元素；op_a 为 t 时元素 (i, k) 位于 a[k * lda + i]
+        template <typename T>
+        void pack_a(op op_a, int mc, int kc, const T *a, int lda, T *packed) {
+            constexpr int mr = blocking<T>::mr;
+            const std::size_t row_step = op_a == op::n ? lda : 1, col_step = op_a == op::n ? 1 : lda;
+            for (int i = 0; i < mc; i += mr) {
+                int rows = std::min(mr, mc - i);
+                for (int k = 0; k < kc; k++) {
+                    for (int r = 0; r < rows; r++)
+                        packed[r] = a[(i + r) * row_step + k * col_step];
+                    for (int r = rows; r < mr; r++)
+                        packed[r] = T(0);
+                    packed += mr;
+                }
+            }
+        }
+
+        // 把 op(B) 的 kc x nc 面板按 nr 列一条打包为 [条][k][nr]，不足的列补 0
+        // b 指向 op(B) 中面板的左上角元素；op_b 为 t 时元素 (k, j) 位于 b[j * ldb + k]
+        template <typename T>
+        void pack_b(op op_b, int kc, int nc, const T *b, int ldb, T *packed, int threads) {
+            constexpr int nr = blocking<T>::nr;
+            const std::size_t row_step = op_b == op::n ? ldb : 1, col_step = op_b == op::n ? 1 : ldb;
+            host_parallel_for((nc + nr - 1) / nr, threads, [=](int s) {
+                int j = s * nr, cols = std::min(nr, nc - j);
+                auto dst = packed + s * nr * kc;
+                for (int k = 0; k < kc; k++) {
+                    auto src = b + k * row_step + j * col_step;
+                    for (int c = 0; c < cols; c++)
+                        dst[c] = src[c * col_step];
+                    for (int c = cols; c < nr; c++)
+                        dst[c] = T(0);
+                    dst += nr;
+                }
+            });
+        }
+
+        // mr x nr 的微内核：每行累加器是一个 nr 宽的 SIMD 向量，整块常驻寄存器
+        // hint: 从 C 中读出已有的部分和继续累加，k 的累加顺序与朴素三重循环一致
+        template <typename T>
+        void micro_kernel(int kc, const T *a, const T *b, T *c, int ldc) {
+            constexpr int mr = blocking<T>::mr, nr = blocking<T>::nr;
+            typedef T simd __attribute__((vector_size(nr * sizeof(T))));
+            simd acc[mr];
+            for (int i = 0; i < mr; i++)
+                std::memcpy(&acc[i], c + std::size_t(i) * ldc, sizeof(simd));
+            for (int k = 0; k < kc; k++, a += mr, b += nr) {
+                simd b_k;
+                std::memcpy(&b_k, b, sizeof(simd));
+                for (int i = 0; i < mr; i++)
+                    acc[i] += a[i] * b_k;
+            }
+            for (int i = 0; i < mr; i++)
+                std::memcpy(c + std::size_t(i) * ldc, &acc[i], sizeof(simd));
+        }
+
+        // 边界上不足 mr x nr 的块先拷贝到补 0 的临时块中计算，再写回有效部分
+        template <typename T>
+        void edge_kernel(int kc, const T *a, const T *b, T *c, int ldc, int rows, int cols, bool accumulate) {
+            constexpr int mr = blocking<T>::mr, nr = blocking<T>::nr;
+            T tile[mr * nr] = {};
+            if (accumulate)
+                for (int i = 0; i < rows; i++)
+                    std::copy_n(c + std::size_t(i) * ldc, cols, tile + i * nr);
+            micro_kernel(kc, a, b, tile, nr);
+            for (int i = 0; i < rows; i++)
+                std::copy_n(tile + i * nr, cols, c + std::size_t(i) * ldc);
+        }
+    }
+
+    // Host 端分块矩阵乘法 c[m][p] = op(a)[m][n] * op(b)[n][p]，lda/ldb/ldc 为存储的行跨度（元素个数）
+    // op(B) 面板与 op(A) 块分别打包成连续条带，转置在打包时完成；外层按 A 块多线程并行
+    template <typename T>
+    void gemm(op op_a, op op_b, int m, int n, int p, const T *a, int lda, const T *b, int ldb, T *c, int ldc, 
+              int threads = 0) {
+        using block = gemm_detail::blocking<T>;
+        constexpr int mr = block::mr, nr = block::nr, kc_max = block::kc, mc_max = block::mc, nc_max = block::nc;
+        if (n == 0) {
+            for (int i = 0; i < m; i++)
+                std::fill_n(c + std::size_t(i) * ldc, p, T(0));
+            return;
+        }
+        std::vector<T> b_packed(std::size_t(kc_max) * nc_max);
+        const int blocks = (m + mc_max - 1) / mc_max;
+        for (int jc = 0; jc < p; jc += nc_max) {
+            const int nc = std::min(nc_max, p - jc);
+            for (int pc = 0; pc < n; pc += kc_max) {
+                const int kc = std::min(kc_max, n - pc);
+                auto b_panel = op_b == op::n ? b + std::size_t(pc) * ldb + jc : b + std::size_t(jc) * ldb + pc;
+                gemm_detail::pack_b(op_b, kc, nc, b_panel, ldb, b_packed.data(), threads);
+                host_parallel_for(blocks, threads, [&](int blk) {
+                    const int ic = blk * mc_max, mc = std::min(mc_max, m - ic);
+                    std::vector<T> a_packed(std::size_t(mc_max) * kc_max);
+                    auto a_block = op_a == op::n ? a + std::size_t(ic) * lda + pc : a + std::size_t(pc) * lda + ic;
+                    gemm_detail::pack_a(op_a, mc, kc, a_block, lda, a_packed.data());
+                    for (int jr = 0; jr < nc; jr += nr) {
+                        for (int ir = 0; ir < mc; ir += mr) {
+                            auto a_sliver = a_packed.data() + ir * kc, b_sliver = b_packed.data() + jr * kc;
+                            auto c_tile = c + std::size_t(ic + ir) * ldc + jc + jr;
+                            int rows = std::min(mr, mc - ir), cols = std::min(nr, nc - jr);
+                            if (rows == mr && cols == nr && pc > 0)
+                                gemm_detail::micro_kernel(kc, a_sliver, b_sliver, c_tile, ldc);
+                            else gemm_detail::edge_kernel(kc, a_sliver, b_sliver, c_tile, ldc, rows, cols, pc > 0);
+                        }
+                    }
+                });
+            }
+        }
+    }
+
+    template <typename T>
+    void gemm(int m, int n, int p, const T *a, int lda, const T *b, int ldb, T *c, int ldc, int threads = 0) {
+        gemm(op::n, op::n, m, n, p, a, lda, b, ldb, c, ldc, threads);
+    }
+}
+
+#endif /* OneAPI_Homework_my_gemm_hpp */
@@ -0,0 +1,132 @@
+#ifndef OneAPI_Homework_my_mapped_hpp
+#define OneAPI_Homework_my_mapped_hpp
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace my {
+
+    // 内存映射文件的 RAII 封装：只读映射已有文件，或者以读写方式映射并把文件调整为指定大小
+    // 映射的页面由操作系统按需读入、换出，因此可以处理比物理内存更大的文件
+    class mapped_file {
+        void *_data = nullptr;
+        std::size_t _size = 0;
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE, mapping = nullptr;
+#endif
+
+    public:
+        // 只读映射整个文件
+        explicit mapped_file(const std::string &path) {
+            open(path, 0, false);
+        }
+
+        // 读写映射：文件不存在时创建，大小调整为 size 字节
+        mapped_file(const std::string &path, std::size_t size) {
+            open(path, size, true);
+        }
+
+        mapped_file(const mapped_file &) = delete;
+        mapped_file &operator=(const mapped_file &) = delete;
+
+        ~mapped_file() {
+#ifdef _WIN32
+            if (_data) UnmapViewOfFile(_data);
+            if (mapping) CloseHandle(mapping);
+            if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+            if (_data) munmap(_data, _size);
+#endif
+        }
+
+        template <typename T = void>
+        T *data() {
+            return static_cast<T *>(_data);
+        }
+
+        template <typename T = void>
+        const T *data() const {
+            return static_cast<const T *>(_data);
+        }
+
+        std::size_t size() const {
+            return _size;
+        }
+
+        // 文件存在时返回其大小，否则返回 0
+        static std::size_t file_size(const std::string &path) {
+#ifdef _WIN32
+            WIN32_FILE_ATTRIBUTE_DATA info;
+            if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &info))
+                return 0;
+            return (std::size_t(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+#else
+            struct stat info;
+            return stat(path.c_str(), &info) == 0 ? std::size_t(info.st_size) : 0;
+#endif
+        }
+
+    private:
+        void open(const std::string &path, std::size_t size, bool writable) {
+#ifdef _WIN32
+            file = CreateFileA(path.c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ,
+                               nullptr, writable ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                throw std::runtime_error("Cannot open " + path);
+            if (!writable) {
+                LARGE_INTEGER file_size;
+                GetFileSizeEx(file, &file_size);
+                size = file_size.QuadPart;
+            }
+            _size = size;
+            if (_size == 0) return;
+            mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+                                         DWORD(std::uint64_t(size) >> 32), DWORD(size), nullptr);
+            if (mapping == nullptr)
+                throw std::runtime_error("Cannot map " + path);
+            _data = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+#else
+            int fd = ::open(path.c_str(), writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+            if (fd < 0)
+                throw std::runtime_error("Cannot open " + path);
+            if (writable && ftruncate(fd, off_t(size)) != 0) {
+                ::close(fd);
+                throw std::runtime_error("Cannot resize " + path);
+            }
+            if (!writable) {
+                struct stat info;
+                fstat(fd, &info);
+                size = info.st_size;
+            }
+            _size = size;
+            if (_size == 0) {
+                ::close(fd);
+                return;
+            }
+            _data = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);    // 映射建立后不再需要文件描述符
+            if (_data == MAP_FAILED)
+                _data = nullptr;
+#endif
+            if (_data == nullptr)
+                throw std::runtime_error("Cannot map " + path);
+        }
+    };
+}
+
+#endif /* OneAPI_Homework_my_mapped_hpp */
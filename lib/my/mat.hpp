@@ -2,10 +2,54 @@
 #define OneAPI_Homework_my_mat_hpp
 #pragma once
 
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
 #include "my.hpp"
+#include "gemm.hpp"
+#include "transpose.hpp"
 
 namespace my {
 
+    // 矩阵存储按页对齐分配：sycl::buffer 以 use_host_ptr 直接使用对齐的 host 内存时，共享内存的设备可以零拷贝
+    constexpr std::size_t storage_alignment = 4096;
+
+    template <typename T>
+    T *allocate_storage(std::size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>, "Matrix elements are copied with memcpy");
+        return static_cast<T *>(::operator new[](count * sizeof(T), std::align_val_t(storage_alignment)));
+    }
+
+    template <typename T>
+    void free_storage(T *data) {
+        ::operator delete[](data, std::align_val_t(storage_alignment));
+    }
+
+    // 在矩阵存储上直接构造 rows x cols 的 sycl::buffer（use_host_ptr）：共享内存的设备上零拷贝，
+    // 其余设备由运行时一次性整块传输；buffer 析构前不应在 host 端访问这块存储
+    template <typename T>
+    sycl::buffer<T, 2> make_buffer(T *data, std::size_t rows, std::size_t cols) {
+        return sycl::buffer<T, 2>(data, sycl::range<2>(rows, cols), {sycl::property::buffer::use_host_ptr()});
+    }
+
+    // 以 const 指针上的矩阵存储构造只读的 rows x cols sycl::buffer：析构时不写回，
+    // 可以有多个这样的 buffer（例如每个设备一个）同时读取同一块存储
+    template <typename T>
+    sycl::buffer<T, 2> make_buffer(const T *data, std::size_t rows, std::size_t cols) {
+        return sycl::buffer<T, 2>(data, sycl::range<2>(rows, cols));
+    }
+
+    // 以 vector 的存储为 host 内存构造只读的一维 sycl::buffer（const 指针，析构时不写回）
+    // hint: 长度为 0 的 buffer 不合法，vector 为空时返回 1 个元素的占位 buffer
+    template <typename T>
+    sycl::buffer<T> make_buffer(const std::vector<T> &vector) {
+        if (vector.empty())
+            return sycl::buffer<T>(sycl::range<1>(1));
+        return sycl::buffer<T>(vector.data(), sycl::range<1>(vector.size()));
+    }
+
     // 使用上面的随机数生成器生成 axb 的随机矩阵，a 和 b 的大小由模板参数指定
     template <typename T, int a, int b>
     void random_matrix(T (&matrix)[a][b], rand<T> &rand) {
@@ -58,36 +102,286 @@ namespace my {
         }
     }
 
+    template <typename T, int M, int N>
+    class mat;
+
+    template <typename T>
+    class dyn_mat;
+
+    // 逐元素表达式模板（CRTP）：a + b - c 之类的表达式只记录操作数，赋值给矩阵时才在一个循环中逐元素求值，
+    // 不分配中间矩阵；表达式以 eval(i) 给出按行主序展开后的第 i 个元素，mat、dyn_mat 本身也是表达式
+    template <typename E>
+    struct mat_expr {
+        const E &self() const {
+            return static_cast<const E &>(*this);
+        }
+    };
+
+    namespace expr_detail {
+
+        // 矩阵操作数按引用保存；子表达式是临时对象，按值保存
+        template <typename E>
+        struct operand {
+            using type = const E;
+        };
+
+        template <typename T, int M, int N>
+        struct operand<mat<T, M, N>> {
+            using type = const mat<T, M, N> &;
+        };
+
+        template <typename T>
+        struct operand<dyn_mat<T>> {
+            using type = const dyn_mat<T> &;
+        };
+    }
+
+    // 两个形状相同的表达式逐元素运算
+    template <typename L, typename R, typename Op>
+    class binary_expr : public mat_expr<binary_expr<L, R, Op>> {
+        typename expr_detail::operand<L>::type l;
+        typename expr_detail::operand<R>::type r;
+
+    public:
+        binary_expr(const L &l, const R &r) : l(l), r(r) {
+            if (l.rows() != r.rows() || l.cols() != r.cols())
+                throw std::runtime_error("Matrix shape mismatch");
+        }
+
+        auto eval(std::size_t i) const {
+            return Op{}(l.eval(i), r.eval(i));
+        }
+
+        int rows() const {
+            return l.rows();
+        }
+
+        int cols() const {
+            return l.cols();
+        }
+    };
+
+    // 表达式逐元素乘以标量
+    template <typename E, typename S>
+    class scaled_expr : public mat_expr<scaled_expr<E, S>> {
+        typename expr_detail::operand<E>::type e;
+        S s;
+
+    public:
+        scaled_expr(const E &e, S s) : e(e), s(s) {}
+
+        auto eval(std::size_t i) const {
+            return e.eval(i) * s;
+        }
+
+        int rows() const {
+            return e.rows();
+        }
+
+        int cols() const {
+            return e.cols();
+        }
+    };
+
+    template <typename L, typename R>
+    binary_expr<L, R, std::plus<>> operator+(const mat_expr<L> &l, const mat_expr<R> &r) {
+        return {l.self(), r.self()};
+    }
+
+    template <typename L, typename R>
+    binary_expr<L, R, std::minus<>> operator-(const mat_expr<L> &l, const mat_expr<R> &r) {
+        return {l.self(), r.self()};
+    }
+
+    template <typename E, typename S, typename = std::enable_if_t<std::is_arithmetic_v<S>>>
+    scaled_expr<E, S> operator*(const mat_expr<E> &e, S s) {
+        return {e.self(), s};
+    }
+
+    template <typename E, typename S, typename = std::enable_if_t<std::is_arithmetic_v<S>>>
+    scaled_expr<E, S> operator*(S s, const mat_expr<E> &e) {
+        return {e.self(), s};
+    }
+
+    // 不拥有存储的矩阵视图：rows x cols 的子矩阵，第 i 行从 data + i * ld 开始（ld 为行跨度，元素个数）
+    // 由 mat / dyn_mat 的 view()、block() 取得，可以继续切分；T 为 const 时是只读视图。视图很小，按值传递
+    // 赋值（包括从另一个视图赋值）写入被引用的元素，而不是改变视图本身引用的位置
+    // hint: 源与目标重叠但位置不同的赋值结果未定义
+    template <typename T>
+    class mat_view : public mat_expr<mat_view<T>> {
+        T *_data;
+        int _rows, _cols;
+        std::size_t _ld;
+
+    public:
+        using value_type = std::remove_const_t<T>;
+
+        mat_view(T *data, int rows, int cols, std::size_t ld) : _data(data), _rows(rows), _cols(cols), _ld(ld) {}
+
+        mat_view(const mat_view &) = default;
+
+        // 只读视图
+        operator mat_view<const T>() const {
+            return {_data, _rows, _cols, _ld};
+        }
+
+        mat_view &operator=(const mat_view &other) {
+            return *this = static_cast<const mat_expr<mat_view> &>(other);
+        }
+
+        template <typename E>
+        mat_view &operator=(const mat_expr<E> &expr) {
+            auto &e = expr.self();
+            if (e.rows() != _rows || e.cols() != _cols)
+                throw std::runtime_error("Matrix shape mismatch");
+            for (int i = 0; i < _rows; i++)
+                for (int j = 0; j < _cols; j++)
+                    (*this)[i][j] = static_cast<value_type>(e.eval(std::size_t(i) * _cols + j));
+            return *this;
+        }
+
+        // 从 (row, col) 开始的 rows x cols 子块
+        mat_view block(int row, int col, int rows, int cols) const {
+            if (row < 0 || col < 0 || rows < 0 || cols < 0 || row + rows > _rows || col + cols > _cols)
+                throw std::runtime_error("Submatrix out of range");
+            return {_data + std::size_t(row) * _ld + col, rows, cols, _ld};
+        }
+
+        T *operator[](int i) const {
+            return _data + std::size_t(i) * _ld;
+        }
+
+        value_type operator()(int i, int j) const {
+            return _data[std::size_t(i) * _ld + j];
+        }
+
+        // 作为表达式时按行主序展开后的第 i 个元素
+        value_type eval(std::size_t i) const {
+            return _data[i / _cols * _ld + i % _cols];
+        }
+
+        template <typename U>
+        bool equal(const mat_view<U> &other, my::equal<value_type> &eq) const {
+            if (_rows != other.rows() || _cols != other.cols())
+                return false;
+            for (int i = 0; i < _rows; i++)
+                for (int j = 0; j < _cols; j++)
+                    if (!eq((*this)[i][j], other[i][j]))
+                        return false;
+            return true;
+        }
+
+        T *data() const {
+            return _data;
+        }
+
+        int rows() const {
+            return _rows;
+        }
+
+        int cols() const {
+            return _cols;
+        }
+
+        std::size_t ld() const {
+            return _ld;
+        }
+
+        // 各行首尾相接，可以当作连续存储访问
+        bool contiguous() const {
+            return _ld == std::size_t(_cols) || _rows <= 1;
+        }
+    };
+
+    // Host 端 c = a * b，三者都是视图，直接在原矩阵的存储上计算，不复制子矩阵
+    template <typename A, typename B, typename T>
+    void gemm(const mat_view<A> &a, const mat_view<B> &b, const mat_view<T> &c, int threads = 0) {
+        static_assert(std::is_same_v<std::remove_const_t<A>, T> && std::is_same_v<std::remove_const_t<B>, T>, 
+                      "Operands and result must have the same element type");
+        if (a.cols() != b.rows() || a.rows() != c.rows() || b.cols() != c.cols())
+            throw std::runtime_error("Matrix shape mismatch");
+        gemm(a.rows(), a.cols(), b.cols(), a.data(), int(a.ld()), b.data(), int(b.ld()), c.data(), int(c.ld()), threads);
+    }
+
+    // sycl::buffer 中从 offset 开始、大小为 range 的子矩阵，与 mat_view 对应的 device 端视图
+    // kernel 通过 access() 取得 ranged accessor，下标相对于 offset，get_range() 为子矩阵的大小
+    // hint: 二维 sub-buffer 只能是整行组成的连续区间，任意矩形子块需要 ranged accessor
+    template <typename T>
+    struct buffer_view {
+        sycl::buffer<T, 2> buffer;      // buffer 是共享的句柄，复制视图不会复制数据
+        sycl::range<2> range;
+        sycl::id<2> offset;
+
+        buffer_view(const sycl::buffer<T, 2> &buffer) : buffer(buffer), range(buffer.get_range()), offset(0, 0) {}
+
+        buffer_view(const sycl::buffer<T, 2> &buffer, sycl::range<2> range, sycl::id<2> offset)
+            : buffer(buffer), range(range), offset(offset) {}
+
+        buffer_view block(std::size_t row, std::size_t col, std::size_t rows, std::size_t cols) const {
+            if (row + rows > range[0] || col + cols > range[1])
+                throw std::runtime_error("Submatrix out of range");
+            return {buffer, sycl::range<2>(rows, cols), sycl::id<2>(offset[0] + row, offset[1] + col)};
+        }
+
+        template <typename... Args>
+        auto access(sycl::handler &h, Args... args) {
+            return sycl::accessor(buffer, h, range, offset, args...);
+        }
+
+        std::size_t rows() const {
+            return range[0];
+        }
+
+        std::size_t cols() const {
+            return range[1];
+        }
+    };
+
     // 二维矩阵 RAII 封装
     template <typename T, int M, int N>
-    class mat {
+    class mat : public mat_expr<mat<T, M, N>> {
         T (*_data)[N];
 
+        void allocate() {
+            _data = reinterpret_cast<T (*)[N]>(allocate_storage<T>(std::size_t(M) * N));
+        }
+
+        // 逐元素求值表达式并写入矩阵：单个连续的循环，没有中间矩阵，可以被编译器向量化
+        // hint: 第 i 个元素只依赖各操作数的第 i 个元素，因此表达式中出现矩阵自身（如 a = a + b）也是安全的
+        template <typename E>
+        void assign(const E &expr) {
+            if (expr.rows() != M || expr.cols() != N)
+                throw std::runtime_error("Matrix shape mismatch");
+            T *out = data();
+            for (std::size_t i = 0; i < std::size_t(M) * N; i++)
+                out[i] = static_cast<T>(expr.eval(i));
+        }
+
     public:
         mat() {
-            _data = new T[M][N];
+            allocate();
         }
 
         mat(T value) {
-            _data = new T[M][N];
+            allocate();
             fill(value);
         }
 
         mat(T *data, std::size_t size = sizeof(T) * M * N) {
             if (data == nullptr) _data = nullptr;
             else {
-                _data = new T[M][N];
+                allocate();
                 std::memcpy(_data, data, size);
             }
         }
 
         mat(const T (&matrix)[M][N]) {
-            _data = new T[M][N];
+            allocate();
             std::memcpy(_data, matrix, sizeof(T) * M * N);
         }
 
         mat(const mat &other) {
-            _data = new T[M][N];
+            allocate();
             std::memcpy(_data, other._data, sizeof(T) * M * N);
         }
 
@@ -96,10 +390,16 @@ namespace my {
             other._data = nullptr;
         }
 
+        template <typename E>
+        mat(const mat_expr<E> &expr) {
+            allocate();
+            assign(expr.self());
+        }
+
         mat &operator=(const mat &other) {
             if (this != &other) {
                 if (_data == nullptr)
-                    _data = new T[M][N];
+                    allocate();
                 std::memcpy(_data, other._data, sizeof(T) * M * N);
             }
             return *this;
@@ -107,14 +407,39 @@ namespace my {
 
         mat &operator=(mat &&other) {
             if (this != &other) {
-                if (_data != nullptr)
-                    delete[] _data;
+                free_storage(_data);
                 _data = other._data;
                 other._data = nullptr;
             }
             return *this;
         }
 
+        template <typename E>
+        mat &operator=(const mat_expr<E> &expr) {
+            if (_data == nullptr)
+                allocate();
+            assign(expr.self());
+            return *this;
+        }
+
+        template <typename E>
+        mat &operator+=(const mat_expr<E> &expr) {
+            assign(*this + expr);
+            return *this;
+        }
+
+        template <typename E>
+        mat &operator-=(const mat_expr<E> &expr) {
+            assign(*this - expr);
+            return *this;
+        }
+
+        mat &operator*=(T scalar) {
+            for (auto &value : *this)
+                value *= scalar;
+            return *this;
+        }
+
         bool operator==(const mat &other) const {
             return std::memcmp(_data, other._data, sizeof(T) * M * N) == 0;
         }
@@ -131,33 +456,15 @@ namespace my {
             return true;
         }
 
-        mat operator+(const mat &other) const {
-            mat result;
-            for (int i = 0; i < M; i++)
-                for (int j = 0; j < N; j++)
-                    result[i][j] = _data[i][j] + other[i][j];
-            return result;
-        }
-
-        mat operator-(const mat &other) const {
-            mat result;
-            for (int i = 0; i < M; i++)
-                for (int j = 0; j < N; j++)
-                    result[i][j] = _data[i][j] - other[i][j];
-            return result;
+        template <typename U>
+        bool equal(const mat_view<U> &other, my::equal<T> &eq) const {
+            return view().equal(other, eq);
         }
 
         template <int P>
         mat<T, M, P> operator*(const mat<T, N, P> &other) const {
             mat<T, M, P> result;
-            for (int i = 0; i < M; i++) {
-                for (int j = 0; j < P; j++) {
-                    T sum = 0;
-                    for (int k = 0; k < N; k++)
-                        sum += _data[i][k] * other[k][j];
-                    result[i][j] = sum;
-                }
-            }
+            my::gemm(M, N, P, begin(), N, other.begin(), P, result.data(), P);
             return result;
         }
 
@@ -169,13 +476,17 @@ namespace my {
             return _data[i][j];
         }
 
+        // 作为表达式时按行主序展开后的第 i 个元素
+        T eval(std::size_t i) const {
+            return _data[0][i];
+        }
+
         auto get_offset() const {
             return [=](int i, int j) { return i * N + j; };
         }
 
         ~mat() {
-            if (_data != nullptr)
-                delete[] _data;
+            free_storage(_data);
         }
 
         T *operator[](int i) {
@@ -225,6 +536,28 @@ namespace my {
             return _data[0];
         }
 
+        // 以矩阵存储为 host 内存的 M x N sycl::buffer，见 my::make_buffer
+        sycl::buffer<T, 2> buffer() {
+            return make_buffer(data(), M, N);
+        }
+
+        mat_view<T> view() {
+            return {data(), M, N, N};
+        }
+
+        mat_view<const T> view() const {
+            return {begin(), M, N, N};
+        }
+
+        // 从 (row, col) 开始的 rows x cols 子块的视图，不复制元素
+        mat_view<T> block(int row, int col, int rows, int cols) {
+            return view().block(row, col, rows, cols);
+        }
+
+        mat_view<const T> block(int row, int col, int rows, int cols) const {
+            return view().block(row, col, rows, cols);
+        }
+
         int size() const {
             return M * N;
         }
@@ -265,9 +598,7 @@ namespace my {
 
         mat<T, N, M> operator!() const {    // transpose
             mat<T, N, M> result;
-            for (int i = 0; i < M; i++)
-                for (int j = 0; j < N; j++)
-                    result[j][i] = _data[i][j];
+            transpose(M, N, begin(), N, result.begin(), M);
             return result;
         }
     };
@@ -276,6 +607,279 @@ namespace my {
     std::ostream &operator<<(std::ostream &os, const mat<float, M, N> &matrix) {
         return matrix.operator<<(os);
     }
+
+    // 运行时确定大小的二维矩阵 RAII 封装，接口与 mat 保持一致
+    template <typename T>
+    class dyn_mat : public mat_expr<dyn_mat<T>> {
+        int _rows, _cols;
+        T *_data;
+
+        // 逐元素求值形状相同的表达式并写入矩阵，见 mat::assign
+        template <typename E>
+        void assign(const E &expr) {
+            if (expr.rows() != _rows || expr.cols() != _cols)
+                throw std::runtime_error("Matrix shape mismatch");
+            for (std::size_t i = 0; i < size(); i++)
+                _data[i] = static_cast<T>(expr.eval(i));
+        }
+
+    public:
+        dyn_mat(int rows, int cols) : _rows(rows), _cols(cols) {
+            _data = allocate_storage<T>(size());
+        }
+
+        dyn_mat(int rows, int cols, T value) : dyn_mat(rows, cols) {
+            fill(value);
+        }
+
+        dyn_mat(int rows, int cols, const T *data) : _rows(rows), _cols(cols) {
+            if (data == nullptr) _data = nullptr;
+            else {
+                _data = allocate_storage<T>(size());
+                std::memcpy(_data, data, size_of());
+            }
+        }
+
+        template <int M, int N>
+        dyn_mat(const mat<T, M, N> &matrix) : dyn_mat(M, N, matrix.begin()) {}
+
+        dyn_mat(const dyn_mat &other) : dyn_mat(other._rows, other._cols, other._data) {}
+
+        dyn_mat(dyn_mat &&other) : _rows(other._rows), _cols(other._cols), _data(other._data) {
+            other._data = nullptr;
+        }
+
+        template <typename E>
+        dyn_mat(const mat_expr<E> &expr) : dyn_mat(expr.self().rows(), expr.self().cols()) {
+            assign(expr.self());
+        }
+
+        dyn_mat &operator=(const dyn_mat &other) {
+            if (this != &other) {
+                if (_data == nullptr || size() != other.size()) {
+                    free_storage(_data);
+                    _data = allocate_storage<T>(other.size());
+                }
+                _rows = other._rows, _cols = other._cols;
+                std::memcpy(_data, other._data, size_of());
+            }
+            return *this;
+        }
+
+        dyn_mat &operator=(dyn_mat &&other) {
+            if (this != &other) {
+                free_storage(_data);
+                _rows = other._rows, _cols = other._cols;
+                _data = other._data;
+                other._data = nullptr;
+            }
+            return *this;
+        }
+
+        // 形状不同时按表达式的形状重新分配；表达式中出现矩阵自身时形状必然相同，不会读到已释放的存储
+        template <typename E>
+        dyn_mat &operator=(const mat_expr<E> &expr) {
+            auto &e = expr.self();
+            if (_data == nullptr || e.rows() != _rows || e.cols() != _cols) {
+                free_storage(_data);
+                _rows = e.rows(), _cols = e.cols();
+                _data = allocate_storage<T>(size());
+            }
+            assign(e);
+            return *this;
+        }
+
+        template <typename E>
+        dyn_mat &operator+=(const mat_expr<E> &expr) {
+            assign(*this + expr);
+            return *this;
+        }
+
+        template <typename E>
+        dyn_mat &operator-=(const mat_expr<E> &expr) {
+            assign(*this - expr);
+            return *this;
+        }
+
+        dyn_mat &operator*=(T scalar) {
+            for (auto &value : *this)
+                value *= scalar;
+            return *this;
+        }
+
+        bool same_shape(const dyn_mat &other) const {
+            return _rows == other._rows && _cols == other._cols;
+        }
+
+        bool operator==(const dyn_mat &other) const {
+            return same_shape(other) && std::memcmp(_data, other._data, size_of()) == 0;
+        }
+
+        bool operator!=(const dyn_mat &other) const {
+            return !(*this == other);
+        }
+
+        bool equal(const dyn_mat &other, my::equal<T> &eq) const {
+            if (!same_shape(other))
+                return false;
+            for (std::size_t i = 0; i < size(); i++)
+                if (!eq(_data[i], other._data[i]))
+                    return false;
+            return true;
+        }
+
+        template <typename U>
+        bool equal(const mat_view<U> &other, my::equal<T> &eq) const {
+            return view().equal(other, eq);
+        }
+
+        dyn_mat operator*(const dyn_mat &other) const {
+            if (_cols != other._rows)
+                throw std::runtime_error("Matrix shape mismatch");
+            dyn_mat result(_rows, other._cols);
+            my::gemm(_rows, _cols, other._cols, _data, _cols, other._data, other._cols, result._data, other._cols);
+            return result;
+        }
+
+        std::ostream &operator<<(std::ostream &os) const {
+            return print_to(os);
+        }
+
+        T operator()(int i, int j) const {
+            return _data[std::size_t(i) * _cols + j];
+        }
+
+        // 作为表达式时按行主序展开后的第 i 个元素
+        T eval(std::size_t i) const {
+            return _data[i];
+        }
+
+        auto get_offset() const {
+            return [cols = _cols](int i, int j) { return i * cols + j; };
+        }
+
+        ~dyn_mat() {
+            free_storage(_data);
+        }
+
+        T *operator[](int i) {
+            return _data + std::size_t(i) * _cols;
+        }
+
+        const T *operator[](int i) const {
+            return _data + std::size_t(i) * _cols;
+        }
+
+        void random(rand<T> &rand) {
+            std::generate(begin(), end(), std::ref(rand));
+        }
+
+        void random(T min = 0, T max = 1) {
+            rand<T> rand(min, max);
+            random(rand);
+        }
+
+        T *begin() {
+            return _data;
+        }
+
+        T *end() {
+            return _data + size();
+        }
+
+        const T *begin() const {
+            return _data;
+        }
+
+        const T *end() const {
+            return _data + size();
+        }
+
+        const T *cbegin() const {
+            return _data;
+        }
+
+        const T *cend() const {
+            return _data + size();
+        }
+
+        T *data() {
+            return _data;
+        }
+
+        const T *data() const {
+            return _data;
+        }
+
+        // 以矩阵存储为 host 内存的 rows x cols sycl::buffer，见 my::make_buffer
+        sycl::buffer<T, 2> buffer() {
+            return make_buffer(_data, _rows, _cols);
+        }
+
+        mat_view<T> view() {
+            return {_data, _rows, _cols, std::size_t(_cols)};
+        }
+
+        mat_view<const T> view() const {
+            return {_data, _rows, _cols, std::size_t(_cols)};
+        }
+
+        // 从 (row, col) 开始的 rows x cols 子块的视图，不复制元素
+        mat_view<T> block(int row, int col, int rows, int cols) {
+            return view().block(row, col, rows, cols);
+        }
+
+        mat_view<const T> block(int row, int col, int rows, int cols) const {
+            return view().block(row, col, rows, cols);
+        }
+
+        std::size_t size() const {
+            return std::size_t(_rows) * _cols;
+        }
+
+        std::size_t size_of() const {
+            return sizeof(T) * size();
+        }
+
+        int rows() const {
+            return _rows;
+        }
+
+        int cols() const {
+            return _cols;
+        }
+
+        void fill(T value) {
+            std::fill(begin(), end(), value);
+        }
+
+        void memset(int value) {
+            std::memset(_data, value, size_of());
+        }
+
+        std::ostream &print_to(std::ostream &os) const {
+            os << "my::dyn_mat(" << _rows << ", " << _cols << ") [";
+            if (_data == nullptr)
+                return os << " null ]";
+            for (int i = 0; i < _rows; i++) {
+                os << "\n  ";
+                for (int j = 0; j < _cols; j++)
+                    os << (*this)[i][j] << " ";
+            }
+            return os << "\n]";
+        }
+
+        dyn_mat operator!() const {    // transpose
+            dyn_mat result(_cols, _rows);
+            transpose(_rows, _cols, begin(), _cols, result.begin(), _rows);
+            return result;
+        }
+    };
+
+    template <typename T>
+    std::ostream &operator<<(std::ostream &os, const dyn_mat<T> &matrix) {
+        return matrix.operator<<(os);
+    }
 }
 
 #endif /* OneAPI_Homework_my_mat_hpp */
\ No newline at end of file
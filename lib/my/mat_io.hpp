@@ -0,0 +1,226 @@
+#ifndef OneAPI_Homework_my_mat_io_hpp
+#define OneAPI_Homework_my_mat_io_hpp
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "my.hpp"
+#include "mat.hpp"
+#include "mapped.hpp"
+
+namespace my {
+
+    // 矩阵文件的两种二进制格式，数据均为行主序、小端：
+    //   .npy：NumPy 的 npy 1.0 格式，文件头补齐到 64 字节的倍数，可以直接用 numpy.load 读取
+    //   raw：本项目的格式，文件头之后的数据从 storage_alignment（页大小）处开始，映射后数据按页对齐，
+    //        可以直接构造零拷贝的 sycl::buffer
+    // 元素类型用 npy 的 descr 字符串描述
+    template <typename T>
+    constexpr const char *npy_descr = nullptr;
+    template <> constexpr const char *npy_descr<float> = "<f4";
+    template <> constexpr const char *npy_descr<double> = "<f8";
+    template <> constexpr const char *npy_descr<sycl::half> = "<f2";
+    template <> constexpr const char *npy_descr<std::int8_t> = "|i1";
+    template <> constexpr const char *npy_descr<std::uint8_t> = "|u1";
+    template <> constexpr const char *npy_descr<std::int16_t> = "<i2";
+    template <> constexpr const char *npy_descr<std::int32_t> = "<i4";
+    template <> constexpr const char *npy_descr<std::int64_t> = "<i8";
+
+    namespace io_detail {
+
+        constexpr char npy_magic[] = "\x93NUMPY";
+        constexpr std::size_t npy_magic_size = 6;
+        constexpr char raw_magic[8] = "MYMAT01";
+
+        struct raw_header {
+            char magic[8];
+            char descr[8];
+            std::uint64_t rows, cols;
+        };
+
+        // 从 npy 文件头的字典中取出 key 对应的值的原始文本
+        inline std::string npy_field(const std::string &header, const std::string &key) {
+            auto pos = header.find("'" + key + "'");
+            if (pos == std::string::npos)
+                throw std::runtime_error("Missing '" + key + "' in npy header");
+            pos = header.find(':', pos) + 1;
+            while (header[pos] == ' ') pos++;
+            auto end = header[pos] == '(' ? header.find(')', pos) + 1 : header.find_first_of(",}", pos);
+            return header.substr(pos, end - pos);
+        }
+
+        // 文件头中的维度必须在 0 ~ INT_MAX 之间，矩阵的行列数以 int 存储
+        inline int checked_dimension(long long value, const std::string &path) {
+            if (value < 0 || value > INT_MAX)
+                throw std::runtime_error(path + ": invalid dimension " + std::to_string(value));
+            return int(value);
+        }
+    }
+
+    // 内存映射加载的只读矩阵：元素直接位于映射的文件页面中，加载时不复制，页面由操作系统按需读入
+    // 根据文件头自动识别 .npy 与 raw 格式；可以作为表达式参与运算，或者复制为 dyn_mat
+    template <typename T>
+    class mapped_mat : public mat_expr<mapped_mat<T>> {
+        mapped_file file;
+        int _rows = 0, _cols = 0;
+        const T *_data = nullptr;
+
+    public:
+        explicit mapped_mat(const std::string &path) : file(path) {
+            auto bytes = file.data<char>();
+            std::string descr;
+            std::size_t offset;
+            if (file.size() >= 10 && std::memcmp(bytes, io_detail::npy_magic, io_detail::npy_magic_size) == 0) {
+                // hint: 1.0 版本的文件头长度为 2 字节，2.0 / 3.0 版本为 4 字节
+                const int version = static_cast<unsigned char>(bytes[6]);
+                if (version < 1 || version > 3)
+                    throw std::runtime_error(path + ": unsupported npy version " + std::to_string(version));
+                std::size_t length = 0, prefix = version == 1 ? 10 : 12;
+                if (file.size() < prefix)
+                    throw std::runtime_error(path + ": npy header is truncated");
+                for (std::size_t i = prefix; i-- > 8;)
+                    length = length << 8 | static_cast<unsigned char>(bytes[i]);
+                if (length > file.size() - prefix)
+                    throw std::runtime_error(path + ": npy header is truncated");
+                std::string header(bytes + prefix, length);
+                descr = io_detail::npy_field(header, "descr");
+                descr = descr.substr(1, descr.size() - 2);
+                if (io_detail::npy_field(header, "fortran_order") != "False")
+                    throw std::runtime_error(path + ": column-major npy files are not supported");
+                // hint: 多读一个维度，以便拒绝 3 维及以上的数组，而不是只取前两维
+                long long rows = 0, cols = 1, extra = 0;
+                auto shape = io_detail::npy_field(header, "shape");
+                auto dimensions = std::sscanf(shape.c_str(), "(%lld ,%lld ,%lld", &rows, &cols, &extra);
+                if (dimensions < 1 || dimensions > 2)
+                    throw std::runtime_error(path + ": only 1-D and 2-D npy arrays are supported");
+                _rows = io_detail::checked_dimension(rows, path), _cols = io_detail::checked_dimension(cols, path);
+                offset = prefix + length;
+            } else if (file.size() >= storage_alignment &&
+                       std::memcmp(bytes, io_detail::raw_magic, sizeof(io_detail::raw_magic)) == 0) {
+                io_detail::raw_header header;
+                std::memcpy(&header, bytes, sizeof(header));
+                descr = std::string(header.descr, strnlen(header.descr, sizeof header.descr));    // descr 不一定以 0 结尾
+                if (header.rows > INT_MAX || header.cols > INT_MAX)
+                    throw std::runtime_error(path + ": invalid dimension " + 
+                                             std::to_string(std::max(header.rows, header.cols)));
+                _rows = int(header.rows), _cols = int(header.cols);
+                offset = storage_alignment;
+            } else throw std::runtime_error(path + ": not a npy or raw matrix file");
+            if (descr != npy_descr<T>)
+                throw std::runtime_error(path + ": element type " + descr + " does not match " + npy_descr<T>);
+            // hint: offset 不超过文件大小，按剩余的元素个数比较，避免乘法溢出
+            if (size() > (file.size() - offset) / sizeof(T))
+                throw std::runtime_error(path + ": file is truncated");
+            _data = reinterpret_cast<const T *>(bytes + offset);
+        }
+
+        T operator()(int i, int j) const {
+            return _data[std::size_t(i) * _cols + j];
+        }
+
+        T eval(std::size_t i) const {
+            return _data[i];
+        }
+
+        const T *operator[](int i) const {
+            return _data + std::size_t(i) * _cols;
+        }
+
+        const T *begin() const {
+            return _data;
+        }
+
+        const T *end() const {
+            return _data + size();
+        }
+
+        const T *data() const {
+            return _data;
+        }
+
+        // 以映射的页面为 host 内存的只读 sycl::buffer（const 指针，不会写回）
+        sycl::buffer<T, 2> buffer() const {
+            return sycl::buffer<T, 2>(_data, sycl::range<2>(_rows, _cols));
+        }
+
+        std::size_t size() const {
+            return std::size_t(_rows) * _cols;
+        }
+
+        std::size_t size_of() const {
+            return sizeof(T) * size();
+        }
+
+        int rows() const {
+            return _rows;
+        }
+
+        int cols() const {
+            return _cols;
+        }
+    };
+
+    namespace expr_detail {
+
+        template <typename T>
+        struct operand<mapped_mat<T>> {
+            using type = const mapped_mat<T> &;
+        };
+    }
+
+    // 加载矩阵文件（.npy 或 raw）并复制为 dyn_mat
+    template <typename T>
+    dyn_mat<T> load_matrix(const std::string &path) {
+        return dyn_mat<T>(mapped_mat<T>(path));
+    }
+
+    // 保存为 npy 1.0 格式；Mat 为 mat、dyn_mat 或 mapped_mat
+    template <typename Mat>
+    void save_npy(const std::string &path, const Mat &matrix) {
+        using T = std::remove_cv_t<std::remove_reference_t<decltype(*matrix.begin())>>;
+        std::string header = "{'descr': '" + std::string(npy_descr<T>) + "', 'fortran_order': False, 'shape': (" +
+                             std::to_string(matrix.rows()) + ", " + std::to_string(matrix.cols()) + "), }";
+        // hint: magic、版本与长度共 10 字节，文件头以换行结尾并用空格补齐，使数据从 64 字节的倍数处开始
+        header.append(63 - (10 + header.size()) % 64, ' ').push_back('\n');
+        std::ofstream ofs(path, std::ios::binary);
+        ofs.write(io_detail::npy_magic, io_detail::npy_magic_size);
+        ofs.put(1).put(0);
+        ofs.put(char(header.size() & 0xff)).put(char(header.size() >> 8));
+        ofs << header;
+        ofs.write(reinterpret_cast<const char *>(matrix.begin()), sizeof(T) * matrix.rows() * matrix.cols());
+        if (!ofs)
+            throw std::runtime_error("Cannot write " + path);
+    }
+
+    // 保存为 raw 格式：文件头占据第一页，数据从 storage_alignment 处开始
+    template <typename Mat>
+    void save_raw(const std::string &path, const Mat &matrix) {
+        using T = std::remove_cv_t<std::remove_reference_t<decltype(*matrix.begin())>>;
+        std::string page(storage_alignment, '\0');
+        io_detail::raw_header header = {};
+        std::memcpy(header.magic, io_detail::raw_magic, sizeof(header.magic));
+        std::strncpy(header.descr, npy_descr<T>, sizeof(header.descr) - 1);
+        header.rows = matrix.rows(), header.cols = matrix.cols();
+        std::memcpy(page.data(), &header, sizeof(header));
+        std::ofstream ofs(path, std::ios::binary);
+        ofs << page;
+        ofs.write(reinterpret_cast<const char *>(matrix.begin()), sizeof(T) * matrix.rows() * matrix.cols());
+        if (!ofs)
+            throw std::runtime_error("Cannot write " + path);
+    }
+
+    // 按扩展名选择格式：.npy 使用 npy 格式，其余使用 raw 格式
+    template <typename Mat>
+    void save_matrix(const std::string &path, const Mat &matrix) {
+        if (path.size() >= 4 && path.compare(path.size() - 4, 4, ".npy") == 0)
+            save_npy(path, matrix);
+        else save_raw(path, matrix);
+    }
+}
+
+#endif /* OneAPI_Homework_my_mat_io_hpp */
@@ -231,6 +231,13 @@ namespace my {
         }
     };
 
+    // 可分离卷积核的两个一维因子：data[i * size + j] == x[i] * y[j]
+    // i 为沿图像 x 方向的偏移，j 为沿 y 方向的偏移，与卷积中访问 data 的下标一致
+    template <typename T, int size>
+    struct separable_factors {
+        T x[size], y[size];
+    };
+
     // 定义一个卷积核
     template <typename T, int size>
     struct kernel {
@@ -278,12 +285,65 @@ namespace my {
         constexpr int get_size() const { return size; }
 
         constexpr T *get_data() { return data; }
+
+        // 秩 1 检验：以幂迭代求最大奇异值 s 及其左右奇异向量 u、v（截断到秩 1 的 SVD），
+        // 残差 ||K - s u v^T||_F 不超过 tolerance * ||K||_F 时卷积核可分离，返回 x = s u、y = v，否则返回空
+        std::optional<separable_factors<T, size>> separate(T tolerance = T(1e-5)) const {
+            double u[size], v[size], norm = 0;
+            for (int e = 0; e < size * size; e++) norm += double(data[e]) * data[e];
+            separable_factors<T, size> factors{};
+            if (norm == 0) return factors;
+            // hint: 以范数最大的一行作为 v 的初值，它与最大奇异值的右奇异向量不正交
+            int start = 0;
+            double best = -1;
+            for (int i = 0; i < size; i++) {
+                double row = 0;
+                for (int j = 0; j < size; j++) row += double(data[i * size + j]) * data[i * size + j];
+                if (row > best) best = row, start = i;
+            }
+            for (int j = 0; j < size; j++) v[j] = data[start * size + j];
+            double sigma = 0;
+            for (int iteration = 0; iteration < 100; iteration++) {
+                double u_norm = 0, v_norm = 0;
+                for (int i = 0; i < size; i++) {
+                    u[i] = 0;
+                    for (int j = 0; j < size; j++) u[i] += data[i * size + j] * v[j];
+                    u_norm += u[i] * u[i];
+                }
+                u_norm = std::sqrt(u_norm);
+                for (int i = 0; i < size; i++) u[i] /= u_norm;
+                for (int j = 0; j < size; j++) {
+                    v[j] = 0;
+                    for (int i = 0; i < size; i++) v[j] += data[i * size + j] * u[i];
+                    v_norm += v[j] * v[j];
+                }
+                v_norm = std::sqrt(v_norm);
+                for (int j = 0; j < size; j++) v[j] /= v_norm;
+                bool converged = std::abs(v_norm - sigma) <= 1e-12 * v_norm;
+                sigma = v_norm;
+                if (converged) break;
+            }
+            double residual = 0;
+            for (int i = 0; i < size; i++)
+                for (int j = 0; j < size; j++) {
+                    auto r = data[i * size + j] - sigma * u[i] * v[j];
+                    residual += r * r;
+                }
+            if (std::sqrt(residual) > tolerance * std::sqrt(norm))
+                return std::nullopt;
+            for (int e = 0; e < size; e++)
+                factors.x[e] = T(sigma * u[e]), factors.y[e] = T(v[e]);
+            return factors;
+        }
     };
 
     // 定义一个高斯卷积核，使用模板元编程计算高斯卷积核的值
+    // 二维高斯函数是两个一维高斯函数之积，因此按构造可分离，separate() 直接给出一维因子
     template <typename T, int size>
     struct gaussian_kernel : kernel<T, size> {
-        explicit constexpr gaussian_kernel(const T sigma = (size - 1) / (T)6.0) {
+        T sigma;
+
+        explicit constexpr gaussian_kernel(const T sigma = (size - 1) / (T)6.0) : sigma(sigma) {
             static_assert(size % 2 == 1, "size must be odd");
             static_assert(size >= 3, "size must be greater than or equal to 3");
             static_assert(std::is_floating_point<T>::value, "T must be floating point");
@@ -299,9 +359,8 @@ namespace my {
 
             const auto get_offset = [](int i, int j) { return (i + offset) * size + j + offset; };
 
-            const auto get_value = [=](int i, int j) {
-                auto x = i - offset;
-                auto y = j - offset;
+            // hint: i、j 已经是相对中心的偏移，不能再减去 offset，否则高斯函数的中心会落在卷积核的角上
+            const auto get_value = [=](int x, int y) {
                 return coeff * std::exp(-(x * x + y * y) / (2.0f * sigma2));
             };
 
@@ -315,6 +374,18 @@ namespace my {
             std::transform(this->data, this->data + size * size, this->data,
                            [=](T v) { return v / sum; });
         }
+
+        // 归一化的一维高斯函数，两个方向相同；参数只为与 kernel::separate 的调用方式一致
+        std::optional<separable_factors<T, size>> separate(T = 0) const {
+            separable_factors<T, size> factors;
+            const int offset = size / 2;
+            T sum = 0;
+            for (int i = 0; i < size; i++)
+                sum += factors.x[i] = std::exp(-T((i - offset) * (i - offset)) / (2 * sigma * sigma));
+            for (int i = 0; i < size; i++)
+                factors.y[i] = factors.x[i] /= sum;
+            return factors;
+        }
     };
 
     // 定义一个锐化卷积核，使用模板元编程计算锐化卷积核的值
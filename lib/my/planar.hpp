@@ -0,0 +1,139 @@
+#ifndef OneAPI_Homework_my_planar_hpp
+#define OneAPI_Homework_my_planar_hpp
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "my.hpp"
+#include "mat.hpp"
+
+namespace my {
+
+    // 按通道分平面存储的图像（SoA）：R、G、B 以及可选的 A 各占一个连续的 height x width 平面，
+    // 依次存放在一块页对齐的存储中，可以直接包装为 planes x height x width 的 sycl::buffer
+    // T 为 std::uint8_t 或 float；float 的取值范围同样是 0 ~ 255，kernel 中不再需要逐个通道转换
+    // 不透明（没有 alpha 通道或 alpha 全为 255）的图像只存储 3 个平面，卷积时 alpha 平面不参与计算
+    template <typename T>
+    class planar_image {
+        static_assert(std::is_same_v<T, std::uint8_t> || std::is_same_v<T, float>, "T must be uint8_t or float");
+
+        int _width = 0, _height = 0, _planes = 0;
+        T *_data = nullptr;
+
+        // 把交错存储的 channels 通道像素拆分到各个平面：灰度图复制到 R、G、B，有 4 个平面时拆出 alpha
+        // hint: 每个线程处理若干整行，同一行内按平面依次写，写入都是连续的
+        void split(const unsigned char *pixels, int channels) {
+            const int alpha = channels == 2 || channels == 4 ? channels - 1 : -1;
+            host_parallel_for(_height, 0, [&](int y) {
+                auto src = pixels + std::size_t(y) * _width * channels;
+                for (int c = 0; c < _planes; c++) {
+                    auto dst = _data + (std::size_t(c) * _height + y) * _width;
+                    const int offset = c == 3 ? alpha : (channels < 3 ? 0 : c);
+                    for (int x = 0; x < _width; x++)
+                        dst[x] = T(src[x * channels + offset]);
+                }
+            });
+        }
+
+        // 交错存储的像素中 alpha 是否全为 255
+        static bool is_opaque(const unsigned char *pixels, std::size_t count, int channels) {
+            if (channels != 2 && channels != 4)
+                return true;
+            for (std::size_t i = 0; i < count; i++)
+                if (pixels[i * channels + channels - 1] != 255)
+                    return false;
+            return true;
+        }
+
+    public:
+        planar_image(int width, int height, int planes) : _width(width), _height(height), _planes(planes) {
+            if (planes != 3 && planes != 4)
+                throw std::runtime_error("Planar image must have 3 or 4 planes");
+            _data = allocate_storage<T>(size());
+        }
+
+        // 从 my::image 转换：只读取一次原始像素，不经过 get_data_rgba 的中间结果
+        explicit planar_image(const image &img)
+            : planar_image(img.get_width(), img.get_height(),
+                           is_opaque(img.get_raw(), std::size_t(img.get_width()) * img.get_height(),
+                                     static_cast<int>(img.get_channels())) ? 3 : 4) {
+            split(img.get_raw(), static_cast<int>(img.get_channels()));
+        }
+
+        planar_image(const image_data_rgba &pixels, int width, int height)
+            : planar_image(width, height,
+                           is_opaque(reinterpret_cast<const unsigned char *>(pixels.data()), pixels.size(), 4) ? 3 : 4) {
+            split(reinterpret_cast<const unsigned char *>(pixels.data()), 4);
+        }
+
+        planar_image(const planar_image &other) : planar_image(other._width, other._height, other._planes) {
+            std::memcpy(_data, other._data, sizeof(T) * size());
+        }
+
+        planar_image(planar_image &&other) noexcept
+            : _width(other._width), _height(other._height), _planes(other._planes), _data(other._data) {
+            other._data = nullptr;
+        }
+
+        planar_image &operator=(planar_image other) noexcept {
+            std::swap(_width, other._width), std::swap(_height, other._height);
+            std::swap(_planes, other._planes), std::swap(_data, other._data);
+            return *this;
+        }
+
+        ~planar_image() {
+            if (_data) free_storage(_data);
+        }
+
+        int width() const { return _width; }
+
+        int height() const { return _height; }
+
+        int planes() const { return _planes; }
+
+        bool opaque() const { return _planes == 3; }
+
+        std::size_t size() const { return std::size_t(_planes) * _height * _width; }
+
+        T *data() { return _data; }
+
+        const T *data() const { return _data; }
+
+        // 第 c 个平面（0 ~ 3 依次为 R、G、B、A）作为 height x width 的矩阵视图
+        mat_view<T> plane(int c) {
+            return {_data + std::size_t(c) * _height * _width, _height, _width, std::size_t(_width)};
+        }
+
+        mat_view<const T> plane(int c) const {
+            return {_data + std::size_t(c) * _height * _width, _height, _width, std::size_t(_width)};
+        }
+
+        // 以图像存储为 host 内存的 planes x height x width 的 sycl::buffer（use_host_ptr）
+        sycl::buffer<T, 3> buffer() {
+            return sycl::buffer<T, 3>(_data, sycl::range<3>(_planes, _height, _width),
+                                      {sycl::property::buffer::use_host_ptr()});
+        }
+
+        // 转换回交错存储的 rgba 像素：float 四舍五入并截断到 0 ~ 255，不透明图像的 alpha 为 255
+        image_data_rgba to_rgba() const {
+            image_data_rgba pixels(std::size_t(_width) * _height);
+            const std::size_t plane_size = std::size_t(_width) * _height;
+            host_parallel_for(_height, 0, [&](int y) {
+                for (int x = 0; x < _width; x++) {
+                    const std::size_t i = std::size_t(y) * _width + x;
+                    for (int c = 0; c < 4; c++) {
+                        float value = c < _planes ? float(_data[c * plane_size + i]) : 255.f;
+                        pixels[i].data[c] = static_cast<unsigned char>(std::clamp(std::round(value), 0.f, 255.f));
+                    }
+                }
+            });
+            return pixels;
+        }
+    };
+}
+
+#endif /* OneAPI_Homework_my_planar_hpp */
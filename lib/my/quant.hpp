@@ -0,0 +1,131 @@
+#ifndef OneAPI_Homework_my_quant_hpp
+#define OneAPI_Homework_my_quant_hpp
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "my.hpp"
+#include "mat.hpp"
+
+namespace my {
+
+    // 零点修正后的 8 位操作数之差在 [-255, 255] 内，乘积不超过 2^16，K 不超过 2^15 时 int32 累加不会溢出
+    constexpr int quantized_max_k = 1 << 15;
+
+    inline void check_quantized_k(int k) {
+        if (k > quantized_max_k)
+            throw std::runtime_error("Quantized GEMM with K = " + std::to_string(k) + " overflows int32 accumulation (K <= " 
+                                     + std::to_string(quantized_max_k) + ")");
+    }
+
+    struct quant_buffers {
+        sycl::buffer<float> scale;
+        sycl::buffer<int> zero_point, sums;
+    };
+
+    // 非对称量化的矩阵：实数 x ≈ scale * (q - zero_point)，T 为 int8_t 或 uint8_t
+    // per_row 为 true 时每行一组量化参数（GEMM 的 A，K 沿行方向），否则每列一组（GEMM 的 B，K 沿列方向）
+    // sums 为每行（或每列）量化值之和，GEMM 用它把零点修正移出 K 循环
+    template <typename T>
+    struct quantized_mat {
+        dyn_mat<T> values;
+        std::vector<float> scale;
+        std::vector<int> zero_point, sums;
+        bool per_row;
+
+        // 把 K 方向上相邻的 4 个元素按小端顺序打包为一个 32 位字，K 补齐到 4 的倍数，补齐的字节为 0
+        // A 打包为 rows x ceil(K / 4)，B 打包为 ceil(K / 4) x cols，同一个字内是 4 个连续的 k，
+        // kernel 每次取一个字即可做 4 路点积（与 dp4a / VNNI 的操作数布局相同）
+        dyn_mat<std::uint32_t> packed_k() const {
+            const int k = per_row ? values.cols() : values.rows(), words = (k + 3) / 4;
+            const int outer = per_row ? values.rows() : values.cols();
+            dyn_mat<std::uint32_t> packed(per_row ? outer : words, per_row ? words : outer, 0u);
+            for (int i = 0; i < outer; i++)
+                for (int e = 0; e < k; e++) {
+                    auto byte = std::uint32_t(static_cast<std::uint8_t>(per_row ? values[i][e] : values[e][i]));
+                    (per_row ? packed[i][e / 4] : packed[e / 4][i]) |= byte << (8 * (e % 4));
+                }
+            return packed;
+        }
+
+        quant_buffers buffers() const {
+            return {make_buffer(scale), make_buffer(zero_point), make_buffer(sums)};
+        }
+
+        // 反量化，用于与 float 结果比较
+        dyn_mat<float> dequantize() const {
+            dyn_mat<float> result(values.rows(), values.cols());
+            for (int i = 0; i < values.rows(); i++)
+                for (int j = 0; j < values.cols(); j++) {
+                    auto g = per_row ? i : j;
+                    result[i][j] = scale[g] * float(int(values[i][j]) - zero_point[g]);
+                }
+            return result;
+        }
+    };
+
+    // 按行（per_row）或按列量化：取该组的 [min(x, 0), max(x, 0)] 映射到 T 的整个取值范围
+    // hint: 区间包含 0，保证实数 0 能被精确表示（补齐与 ReLU 后的 0 不引入误差）
+    template <typename T, typename Mat>
+    quantized_mat<T> quantize(const Mat &x, bool per_row) {
+        constexpr int q_min = std::numeric_limits<T>::min(), q_max = std::numeric_limits<T>::max();
+        const int groups = per_row ? x.rows() : x.cols(), length = per_row ? x.cols() : x.rows();
+        quantized_mat<T> result{dyn_mat<T>(x.rows(), x.cols()), std::vector<float>(groups),
+                                std::vector<int>(groups), std::vector<int>(groups), per_row};
+        for (int g = 0; g < groups; g++) {
+            auto at = [&](int e) { return per_row ? x[g][e] : x[e][g]; };
+            float lo = 0.f, hi = 0.f;
+            for (int e = 0; e < length; e++)
+                lo = std::min(lo, float(at(e))), hi = std::max(hi, float(at(e)));
+            float scale = hi > lo ? (hi - lo) / float(q_max - q_min) : 1.f;
+            int zero_point = std::clamp(int(std::lround(q_min - lo / scale)), q_min, q_max);
+            int sum = 0;
+            for (int e = 0; e < length; e++) {
+                auto q = T(std::clamp(int(std::lround(at(e) / scale)) + zero_point, q_min, q_max));
+                (per_row ? result.values[g][e] : result.values[e][g]) = q;
+                sum += q;
+            }
+            result.scale[g] = scale, result.zero_point[g] = zero_point, result.sums[g] = sum;
+        }
+        return result;
+    }
+
+    // 4 路整数点积：a、b 各含 4 个按小端打包的 TA、TB 元素，乘积以 int32 累加
+    template <typename TA, typename TB>
+    inline int dot4(std::uint32_t a, std::uint32_t b) {
+        int sum = 0;
+        for (int s = 0; s < 32; s += 8)
+            sum += int(static_cast<TA>(static_cast<std::uint8_t>(a >> s))) *
+                   int(static_cast<TB>(static_cast<std::uint8_t>(b >> s)));
+        return sum;
+    }
+
+    // Host 参考实现：c[i][j] = Σ_k (a[i][k] - za[i]) * (b[k][j] - zb[j])，int32 累加，结果是精确的
+    // K 超过 quantized_max_k 时抛出异常
+    template <typename TA, typename TB>
+    dyn_mat<std::int32_t> quantized_gemm(const quantized_mat<TA> &a, const quantized_mat<TB> &b, int threads = 0) {
+        const int m = a.values.rows(), n = a.values.cols(), p = b.values.cols();
+        if (n != b.values.rows() || !a.per_row || b.per_row)
+            throw std::runtime_error("Matrix shape mismatch");
+        check_quantized_k(n);
+        dyn_mat<std::int32_t> c(m, p, 0);
+        host_parallel_for(m, threads, [&](int i) {
+            auto c_row = c[i];
+            for (int k = 0; k < n; k++) {
+                const int x = int(a.values[i][k]) - a.zero_point[i];
+                auto b_row = b.values[k];
+                for (int j = 0; j < p; j++)
+                    c_row[j] += x * (int(b_row[j]) - b.zero_point[j]);
+            }
+        });
+        return c;
+    }
+}
+
+#endif /* OneAPI_Homework_my_quant_hpp */
@@ -0,0 +1,152 @@
+#ifndef OneAPI_Homework_my_sparse_hpp
+#define OneAPI_Homework_my_sparse_hpp
+#pragma once
+
+#include <vector>
+
+#include "my.hpp"
+#include "mat.hpp"
+
+namespace my {
+
+    template <typename T>
+    struct csr_buffers {
+        sycl::buffer<int> row_ptr, col_idx;
+        sycl::buffer<T> values;
+    };
+
+    // CSR 稀疏矩阵：第 i 行的非零元为 values[row_ptr[i] .. row_ptr[i + 1])，列号在 col_idx 的同一区间中
+    // 每行内的非零元按列号递增存放，因此逐行累加的顺序与稠密矩阵的朴素乘法一致
+    template <typename T>
+    class csr_mat {
+        int _rows, _cols;
+        std::vector<int> _row_ptr, _col_idx;
+        std::vector<T> _values;
+
+    public:
+        // 从稠密矩阵（mat 或 dyn_mat）转换，只保留不为 0 的元素
+        template <typename Mat>
+        explicit csr_mat(const Mat &dense) : _rows(dense.rows()), _cols(dense.cols()), _row_ptr(1, 0) {
+            _row_ptr.reserve(_rows + 1);
+            for (int i = 0; i < _rows; i++) {
+                for (int j = 0; j < _cols; j++)
+                    if (dense[i][j] != T(0))
+                        _col_idx.push_back(j), _values.push_back(dense[i][j]);
+                _row_ptr.push_back(static_cast<int>(_values.size()));
+            }
+        }
+
+        // 还原为稠密矩阵
+        dyn_mat<T> dense() const {
+            dyn_mat<T> result(_rows, _cols, T(0));
+            for (int i = 0; i < _rows; i++)
+                for (int e = _row_ptr[i]; e < _row_ptr[i + 1]; e++)
+                    result[i][_col_idx[e]] = _values[e];
+            return result;
+        }
+
+        csr_buffers<T> buffers() const {
+            return {make_buffer(_row_ptr), make_buffer(_col_idx), make_buffer(_values)};
+        }
+
+        int rows() const {
+            return _rows;
+        }
+
+        int cols() const {
+            return _cols;
+        }
+
+        std::size_t nnz() const {
+            return _values.size();
+        }
+
+        // 非零元所占的比例
+        double density() const {
+            return double(nnz()) / (double(_rows) * _cols);
+        }
+
+        // 存储占用的字节数
+        std::size_t size_of() const {
+            return sizeof(int) * (_row_ptr.size() + _col_idx.size()) + sizeof(T) * _values.size();
+        }
+
+        const std::vector<int> &row_ptr() const {
+            return _row_ptr;
+        }
+
+        const std::vector<int> &col_idx() const {
+            return _col_idx;
+        }
+
+        const std::vector<T> &values() const {
+            return _values;
+        }
+    };
+
+    template <typename T>
+    struct sell_buffers {
+        sycl::buffer<int> slice_ptr, slice_width, col_idx;
+        sycl::buffer<T> values;
+    };
+
+    // Sliced ELL 稀疏矩阵：每 slice_height 行为一片，片内各行补齐到该片最长行的非零元个数 slice_width[s]，
+    // 片内按列主序存放，第 s 片中第 r 行的第 j 个非零元位于 slice_ptr[s] + j * slice_height + r
+    // 相邻行的同一序号非零元地址相邻，一个 work-item 处理一行时读取是合并的；补齐的元素列号为 0、值为 0
+    // slice_height 不小于行数时即为普通的 ELL 格式
+    template <typename T>
+    class sell_mat {
+        int _rows, _cols, _slice_height;
+        std::vector<int> _slice_ptr, _slice_width, _col_idx;
+        std::vector<T> _values;
+
+    public:
+        explicit sell_mat(const csr_mat<T> &csr, int slice_height = 32)
+            : _rows(csr.rows()), _cols(csr.cols()), _slice_height(slice_height), _slice_ptr(1, 0) {
+            auto &row_ptr = csr.row_ptr();
+            for (int first = 0; first < _rows; first += _slice_height) {
+                const int last = std::min(first + _slice_height, _rows);
+                int width = 0;
+                for (int i = first; i < last; i++)
+                    width = std::max(width, row_ptr[i + 1] - row_ptr[i]);
+                const std::size_t base = _values.size();
+                _slice_width.push_back(width);
+                _slice_ptr.push_back(static_cast<int>(base + std::size_t(width) * _slice_height));
+                _col_idx.resize(_slice_ptr.back(), 0);
+                _values.resize(_slice_ptr.back(), T(0));
+                for (int i = first; i < last; i++)
+                    for (int e = row_ptr[i], j = 0; e < row_ptr[i + 1]; e++, j++) {
+                        _col_idx[base + std::size_t(j) * _slice_height + (i - first)] = csr.col_idx()[e];
+                        _values[base + std::size_t(j) * _slice_height + (i - first)] = csr.values()[e];
+                    }
+            }
+        }
+
+        sell_buffers<T> buffers() const {
+            return {make_buffer(_slice_ptr), make_buffer(_slice_width), make_buffer(_col_idx), make_buffer(_values)};
+        }
+
+        int rows() const {
+            return _rows;
+        }
+
+        int cols() const {
+            return _cols;
+        }
+
+        int slice_height() const {
+            return _slice_height;
+        }
+
+        // 存储的元素个数（含补齐的 0）
+        std::size_t stored() const {
+            return _values.size();
+        }
+
+        std::size_t size_of() const {
+            return sizeof(int) * (_slice_ptr.size() + _slice_width.size() + _col_idx.size()) + sizeof(T) * _values.size();
+        }
+    };
+}
+
+#endif /* OneAPI_Homework_my_sparse_hpp */
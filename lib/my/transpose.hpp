@@ -0,0 +1,58 @@
+#ifndef OneAPI_Homework_my_transpose_hpp
+#define OneAPI_Homework_my_transpose_hpp
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include "gemm.hpp"
+
+namespace my {
+
+    namespace transpose_detail {
+
+        // 递归到两维都不超过 leaf 时直接转置：32 x 32 的 float 块读写各占 4 KiB，源块与目标块同时留在 L1 中
+        constexpr int leaf = 32;
+
+        // 每个线程负责的方块边长
+        constexpr int panel = 256;
+
+        // 元素数少于 serial_size 时单线程转置，避免创建线程的开销
+        constexpr std::size_t serial_size = std::size_t(1) << 16;
+
+        // 缓存无关的递归转置：每次沿较长的一维对半划分，子问题总会在某一层恰好放进各级缓存，不需要针对缓存大小调参
+        template <typename T>
+        void recurse(int rows, int cols, const T *src, std::size_t lds, T *dst, std::size_t ldd) {
+            if (rows <= leaf && cols <= leaf) {
+                for (int i = 0; i < rows; i++)
+                    for (int j = 0; j < cols; j++)
+                        dst[std::size_t(j) * ldd + i] = src[std::size_t(i) * lds + j];
+            } else if (rows >= cols) {
+                const int half = rows / 2;
+                recurse(half, cols, src, lds, dst, ldd);
+                recurse(rows - half, cols, src + std::size_t(half) * lds, lds, dst + half, ldd);
+            } else {
+                const int half = cols / 2;
+                recurse(rows, half, src, lds, dst, ldd);
+                recurse(rows, cols - half, src + half, lds, dst + std::size_t(half) * ldd, ldd);
+            }
+        }
+    }
+
+    // dst[j][i] = src[i][j]，src 为 rows x cols，lds、ldd 分别为两者的行距（元素个数）
+    // 矩阵按 panel x panel 的方块分给各线程，方块内递归转置；src 与 dst 不能重叠
+    template <typename T>
+    void transpose(int rows, int cols, const T *src, std::size_t lds, T *dst, std::size_t ldd, int threads = 0) {
+        using transpose_detail::panel;
+        const int row_panels = (rows + panel - 1) / panel, col_panels = (cols + panel - 1) / panel;
+        if (std::size_t(rows) * cols < transpose_detail::serial_size)
+            threads = 1;
+        host_parallel_for(row_panels * col_panels, threads, [=](int b) {
+            const int i = b / col_panels * panel, j = b % col_panels * panel;
+            transpose_detail::recurse(std::min(panel, rows - i), std::min(panel, cols - j),
+                                      src + std::size_t(i) * lds + j, lds, dst + std::size_t(j) * ldd + i, ldd);
+        });
+    }
+}
+
+#endif /* OneAPI_Homework_my_transpose_hpp */
@@ -0,0 +1,56 @@
+#ifndef OneAPI_Homework_my_tune_hpp
+#define OneAPI_Homework_my_tune_hpp
+#pragma once
+
+#include <fstream>
+#include <map>
+#include <optional>
+#include <string>
+
+#include "my.hpp"
+
+namespace my {
+
+    // 以 (设备名, 键) 为索引的调优结果缓存，持久化为文本文件
+    // 文件每行一条记录：设备名 \t 键 \t 取值
+    class tuning_cache {
+        std::string filename;
+        std::map<std::pair<std::string, std::string>, std::string> entries;
+
+    public:
+        explicit tuning_cache(std::string filename = "tuning.txt") : filename(std::move(filename)) {
+            std::ifstream ifs(this->filename);
+            std::string device, key, value;
+            while (std::getline(ifs, device, '\t') && std::getline(ifs, key, '\t') && std::getline(ifs, value))
+                entries[{device, key}] = value;
+        }
+
+        std::optional<std::string> find(const device_info &device, const std::string &key) const {
+            auto it = entries.find({device.name, key});
+            if (it == entries.end())
+                return std::nullopt;
+            return it->second;
+        }
+
+        // 更新一条记录并立即写回文件
+        void store(const device_info &device, const std::string &key, const std::string &value) {
+            entries[{device.name, key}] = value;
+            std::ofstream ofs(filename);
+            for (auto &[index, entry] : entries)
+                ofs << index.first << '\t' << index.second << '\t' << entry << '\n';
+        }
+    };
+
+    // 问题规模分桶：每一维向上取整到 2 的幂，例如 1000x777x500 -> 1024x1024x512
+    inline std::string size_bucket(std::initializer_list<std::size_t> dims) {
+        std::string bucket;
+        for (auto dim : dims) {
+            std::size_t pow2 = 1;
+            while (pow2 < dim) pow2 <<= 1;
+            bucket += (bucket.empty() ? "" : "x") + std::to_string(pow2);
+        }
+        return bucket;
+    }
+}
+
+#endif /* OneAPI_Homework_my_tune_hpp */
@@ -0,0 +1,89 @@
+#ifndef OneAPI_Homework_my_verify_hpp
+#define OneAPI_Homework_my_verify_hpp
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "my.hpp"
+#include "gemm.hpp"
+
+namespace my {
+
+    struct freivalds_result {
+        bool passed;
+        int rounds;
+        double max_error, tolerance;
+    };
+
+    // 误判概率不超过 false_positive 所需的轮数；false_positive 必须在 (0, 1) 内
+    inline int freivalds_rounds(double false_positive) {
+        if (!(false_positive > 0 && false_positive < 1))
+            throw std::runtime_error("Freivalds false positive rate must be in (0, 1)");
+        return std::max(1, int(std::ceil(std::log2(1 / false_positive))));
+    }
+
+    // Freivalds 算法随机验证 c == a * b：每轮取各分量为 ±1 的随机向量 x，比较 a(bx) 与 cx，只需 O(mn + np + mp) 次运算
+    // c != ab 时单轮通过的概率不超过 1/2，全部 freivalds_rounds(false_positive) 轮通过时误判的概率不超过 false_positive
+    // 向量运算以 double 进行，用 my::equal 比较 a(bx) 与 cx 的每个分量；c 的误差按随机游走估计：
+    // float 累加 K 次的舍入误差约为 sqrt(K) eps (|a| |b|)_ij，各元素的容差 tolerance 也按独立误差计，
+    // 以随机符号求和后一行上的标准差不超过 sqrt(K / p) eps (|a| |b| 1)_i + sqrt(p) tolerance，容差取其 8 倍
+    // hint: 远小于容差的偏差不能被检出，这与逐元素比较时容差的含义一致
+    template <typename MatA, typename MatB, typename MatC>
+    freivalds_result freivalds(const MatA &a, const MatB &b, const MatC &c, float tolerance, double false_positive,
+                               int threads = 0) {
+        const int m = a.rows(), n = a.cols(), p = b.cols();
+        if (b.rows() != n || c.rows() != m || c.cols() != p)
+            throw std::runtime_error("Matrix shape mismatch");
+        if (m == 0 || p == 0)
+            return {true, 0, 0, 0};     // c 没有元素，不需要验证
+
+        // 行 i 上的误差界 (|a| |b| 1)_i，与 x 无关，只计算一次
+        std::vector<double> b_abs(n), bound(m);
+        host_parallel_for(n, threads, [&](int k) {
+            double sum = 0;
+            for (int j = 0; j < p; j++) sum += std::abs(double(b[k][j]));
+            b_abs[k] = sum;
+        });
+        host_parallel_for(m, threads, [&](int i) {
+            double sum = 0;
+            for (int k = 0; k < n; k++) sum += std::abs(double(a[i][k])) * b_abs[k];
+            bound[i] = sum;
+        });
+        const double scale = *std::max_element(bound.begin(), bound.end());
+        freivalds_result result{true, freivalds_rounds(false_positive), 0,
+                                8 * (std::sqrt(double(n) / p) * std::numeric_limits<float>::epsilon() * scale + 
+                                     std::sqrt(double(p)) * tolerance)};
+        my::equal<double> eq(result.tolerance);
+
+        my::rand<int> sign(0, 1);
+        sign.e.seed(std::random_device{}());
+        std::vector<double> x(p), bx(n);
+        for (int round = 0; round < result.rounds; round++) {
+            std::generate(x.begin(), x.end(), [&] { return sign() ? 1.0 : -1.0; });
+            host_parallel_for(n, threads, [&](int k) {
+                double sum = 0;
+                for (int j = 0; j < p; j++) sum += double(b[k][j]) * x[j];
+                bx[k] = sum;
+            });
+            std::vector<double> errors(m);
+            host_parallel_for(m, threads, [&](int i) {
+                double abx = 0, cx = 0;
+                for (int k = 0; k < n; k++) abx += double(a[i][k]) * bx[k];
+                for (int j = 0; j < p; j++) cx += double(c[i][j]) * x[j];
+                errors[i] = abx - cx;
+            });
+            for (auto error : errors) {
+                result.max_error = std::max(result.max_error, std::abs(error));
+                if (!eq(error, 0)) result.passed = false;
+            }
+            if (!result.passed) break;
+        }
+        return result;
+    }
+}
+
+#endif /* OneAPI_Homework_my_verify_hpp */
@@ -1,8 +1,13 @@
 #include <sycl/sycl.hpp>
 #include <iostream>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "my.hpp"
+#include "my/fft.hpp"
+#include "my/planar.hpp"
+#include "my/tune.hpp"
 
 // #define coordinate_fix
 
@@ -43,6 +48,60 @@ my::image_data_rgba host_convolution(int width, int height, const my::image_data
     return output;
 }
 
+// 可分离卷积：先沿 x 方向以 factors.x 卷积，再沿 y 方向以 factors.y 卷积，每个像素 2N 次乘加而不是 N^2 次
+// 越界的点不参与计算，有效区域是矩形，二维的有效权重和等于两个方向的有效权重和之积，因此逐次归一化与二维路径等价
+// hint: 中间结果以 float 保存，只在最后取整一次；与二维路径的差别只来自浮点舍入，输出最多相差 1
+template <typename T, int N>
+my::image_data_rgba host_separable_convolution(int width, int height, const my::image_data_rgba &input, 
+                                               const my::separable_factors<T, N> &factors, bool normalize = true) {
+    constexpr auto kernel_offset = N / 2;
+    std::vector<sycl::float4> temp(width * height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            sycl::float4 sum(0.f);
+            float sum_weight = 0.0f;
+            for (int i = 0; i < N; ++i) {
+                int inputX = x + i - kernel_offset;
+                if (inputX >= 0 && inputX < width) {
+                    auto &pixel = input[y * width + inputX];
+                    sum += sycl::float4(float(pixel.r), float(pixel.g), float(pixel.b), float(pixel.a)) * factors.x[i];
+                    sum_weight += factors.x[i];
+                }
+            }
+            temp[y * width + x] = normalize ? sum * (1.f / sum_weight) : sum;
+        }
+    }
+    my::image_data_rgba output(width * height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            sycl::float4 sum(0.f);
+            float sum_weight = 0.0f;
+            for (int j = 0; j < N; ++j) {
+                int inputY = y + j - kernel_offset;
+                if (inputY >= 0 && inputY < height) {
+                    sum += temp[inputY * width + x] * factors.y[j];
+                    sum_weight += factors.y[j];
+                }
+            }
+            if (normalize)
+                sum = sum * (1.f / sum_weight);
+            output[y * width + x] = my::make_pixel_rgba(sum[0], sum[1], sum[2], sum[3]);
+        }
+    }
+    return output;
+}
+
+// 等待 kernel 完成并返回其耗时（ms）
+double event_duration(sycl::event event) {
+    event.wait();
+    auto start = event.get_profiling_info<sycl::info::event_profiling::command_start>();
+    auto end = event.get_profiling_info<sycl::info::event_profiling::command_end>();
+    return (end - start) * 1e-6;
+}
+
+template <int kernel_size>
+class ConvolutionKernel;
+
 template <int kernel_size>
 double device_convolution(sycl::queue &queue, sycl::buffer<my::pixel_rgba, 2> &buffer_input, 
                           sycl::buffer<my::pixel_rgba, 2> &buffer_output, 
@@ -53,8 +112,9 @@ double device_convolution(sycl::queue &queue, sycl::buffer<my::pixel_rgba, 2> &b
         auto accessor_output = buffer_output.get_access<sycl::access::mode::write>(cgh);
         auto accessor_kernel = buffer_kernel.get_access<sycl::access::mode::read>(cgh);
 
-        // hint: sycl::handle::parallel_for 的第一个类型参数是用户指定的 kernel 名称，程序内需要保证唯一
-        cgh.parallel_for<class ConvolutionKernel>(sycl::range<2>(height, width), [=](sycl::item<2> item) {
+        // hint: sycl::handle::parallel_for 的第一个类型参数是用户指定的 kernel 名称，程序内需要保证唯一；
+        //       每种卷积核大小各实例化一次，因此名称也以大小为模板参数
+        cgh.parallel_for<ConvolutionKernel<kernel_size>>(sycl::range<2>(height, width), [=](sycl::item<2> item) {
             
             int y = item.get_id(0);
             int x = item.get_id(1);
@@ -91,7 +151,420 @@ double device_convolution(sycl::queue &queue, sycl::buffer<my::pixel_rgba, 2> &b
     return (end - start) * 1e-6;
 }
 
-int main() {
+// 分块卷积中每个 work-group 负责的输出块边长
+constexpr int convolution_tile = 16;
+
+template <int kernel_size>
+class TiledConvolutionKernel;
+
+// 分块卷积：每个 work-group 先把 tile x tile 的输出块及其四周 kernel_size / 2 宽的边缘（halo）协作读入 local memory，
+// barrier 之后从 local memory 卷积，每个输入像素只从全局内存读取 (1 + 2 * offset / tile)^2 次，而不是 kernel_size^2 次
+// 卷积核也一并读入 local memory；计算顺序与 device_convolution 相同，结果逐位一致
+// hint: 图像外的 halo 不读取，卷积时与 device_convolution 一样按坐标跳过，因此 local memory 中这些位置不需要初始化
+template <int kernel_size, int tile = convolution_tile>
+double device_tiled_convolution(sycl::queue &queue, sycl::buffer<my::pixel_rgba, 2> &buffer_input, 
+                                sycl::buffer<my::pixel_rgba, 2> &buffer_output, 
+                                sycl::buffer<float, 2> &buffer_kernel, int width, int height,
+                                const my::kernel<float, kernel_size> &) {
+    constexpr int kernel_offset = kernel_size / 2, local_size = tile + 2 * kernel_offset;
+    // hint: 全局范围向上取整到 tile 的倍数，多出的 work-item 参与读入但不写出
+    sycl::range<2> global((height + tile - 1) / tile * tile, (width + tile - 1) / tile * tile);
+    auto event = queue.submit([&](sycl::handler& cgh) {
+        auto accessor_input = buffer_input.get_access<sycl::access::mode::read>(cgh);
+        auto accessor_output = buffer_output.get_access<sycl::access::mode::write>(cgh);
+        auto accessor_kernel = buffer_kernel.get_access<sycl::access::mode::read>(cgh);
+        sycl::local_accessor<my::pixel_rgba, 2> local_input(sycl::range<2>(local_size, local_size), cgh);
+        sycl::local_accessor<float, 2> local_kernel(sycl::range<2>(kernel_size, kernel_size), cgh);
+
+        cgh.parallel_for<TiledConvolutionKernel<kernel_size>>(
+                sycl::nd_range<2>(global, sycl::range<2>(tile, tile)), [=](sycl::nd_item<2> item) {
+            const int ly = item.get_local_id(0), lx = item.get_local_id(1), lid = ly * tile + lx;
+            const int y0 = item.get_group(0) * tile - kernel_offset, x0 = item.get_group(1) * tile - kernel_offset;
+
+            // 相邻的 work-item 读取同一行中相邻的像素，全局内存访问是合并的
+            for (int e = lid; e < local_size * local_size; e += tile * tile) {
+                int inputY = y0 + e / local_size, inputX = x0 + e % local_size;
+                if (inputX >= 0 && inputX < width && inputY >= 0 && inputY < height)
+                    local_input[e / local_size][e % local_size] = accessor_input[{(unsigned)inputY, (unsigned)inputX}];
+            }
+            for (int e = lid; e < kernel_size * kernel_size; e += tile * tile)
+                local_kernel[e / kernel_size][e % kernel_size] = accessor_kernel[{(unsigned)(e / kernel_size), 
+                                                                                  (unsigned)(e % kernel_size)}];
+            item.barrier(sycl::access::fence_space::local_space);
+
+            const int y = item.get_global_id(0), x = item.get_global_id(1);
+            if (x >= width || y >= height) return;
+            float sum_r = 0.0f, sum_g = 0.0f, sum_b = 0.0f, sum_a = 0.0f;
+            float sum_weight = 0.0f;
+            for (int i = 0; i < kernel_size; ++i) {
+                for (int j = 0; j < kernel_size; ++j) {
+                    int inputX = x + i - kernel_offset;
+                    int inputY = y + j - kernel_offset;
+
+                    if (inputX >= 0 && inputX < width && inputY >= 0 && inputY < height) {
+                        auto weight = local_kernel[i][j];
+                        auto &pixel = local_input[ly + j][lx + i];
+                        sum_r += pixel.r * weight;
+                        sum_g += pixel.g * weight;
+                        sum_b += pixel.b * weight;
+                        sum_a += pixel.a * weight;
+                        sum_weight += weight;
+                    }
+                }
+            }
+            sum_r /= sum_weight, sum_g /= sum_weight, sum_b /= sum_weight, sum_a /= sum_weight;
+            accessor_output[{(unsigned)y, (unsigned)x}] = my::make_pixel_rgba(sum_r, sum_g, sum_b, sum_a);
+        });
+    });
+    return event_duration(event);
+}
+
+// 可分离卷积的 device 版本：横向一趟写入 float 的中间 buffer，纵向一趟取整写出，返回两趟 kernel 的总耗时
+template <int kernel_size>
+double device_separable_convolution(sycl::queue &queue, sycl::buffer<my::pixel_rgba, 2> &buffer_input, 
+                                    sycl::buffer<my::pixel_rgba, 2> &buffer_output, int width, int height,
+                                    const my::separable_factors<float, kernel_size> &factors) {
+    constexpr auto kernel_offset = kernel_size / 2;
+    sycl::buffer<sycl::float4, 2> buffer_temp(sycl::range<2>(height, width));
+    auto horizontal = queue.submit([&](sycl::handler& cgh) {
+        auto accessor_input = buffer_input.get_access<sycl::access::mode::read>(cgh);
+        auto accessor_temp = buffer_temp.get_access<sycl::access::mode::write>(cgh);
+        cgh.parallel_for(sycl::range<2>(height, width), [=](sycl::item<2> item) {
+            int y = item.get_id(0);
+            int x = item.get_id(1);
+            sycl::float4 sum(0.f);
+            float sum_weight = 0.0f;
+            for (int i = 0; i < kernel_size; ++i) {
+                int inputX = x + i - kernel_offset;
+                if (inputX >= 0 && inputX < width) {
+                    auto pixel = accessor_input[{(unsigned)y, (unsigned)inputX}];
+                    sum += sycl::float4(float(pixel.r), float(pixel.g), float(pixel.b), float(pixel.a)) * factors.x[i];
+                    sum_weight += factors.x[i];
+                }
+            }
+            accessor_temp[item] = sum * (1.f / sum_weight);
+        });
+    });
+    auto vertical = queue.submit([&](sycl::handler& cgh) {
+        auto accessor_temp = buffer_temp.get_access<sycl::access::mode::read>(cgh);
+        auto accessor_output = buffer_output.get_access<sycl::access::mode::write>(cgh);
+        cgh.parallel_for(sycl::range<2>(height, width), [=](sycl::item<2> item) {
+            int y = item.get_id(0);
+            int x = item.get_id(1);
+            sycl::float4 sum(0.f);
+            float sum_weight = 0.0f;
+            for (int j = 0; j < kernel_size; ++j) {
+                int inputY = y + j - kernel_offset;
+                if (inputY >= 0 && inputY < height) {
+                    sum += accessor_temp[{(unsigned)inputY, (unsigned)x}] * factors.y[j];
+                    sum_weight += factors.y[j];
+                }
+            }
+            sum = sum * (1.f / sum_weight);
+            accessor_output[item] = my::make_pixel_rgba(sum[0], sum[1], sum[2], sum[3]);
+        });
+    });
+    return event_duration(horizontal) + event_duration(vertical);
+}
+
+// 平面图像卷积中每个 work-item 沿 x 方向计算的像素数
+constexpr int planar_lanes = 4;
+
+template <int kernel_size, typename TI, typename TO>
+class PlanarConvolutionKernel;
+
+// 平面（SoA）图像的卷积：每个 work-item 在一个平面上计算同一行相邻的 planar_lanes 个像素，累加器是 sycl::vec，
+// 每个 tap 对各个像素做同样的乘加；卷积核的每一行只读取一次覆盖 lanes + kernel_size - 1 个像素的窗口，
+// 各 tap 从窗口中取相邻的 lanes 个值，读取次数从 lanes * kernel_size 降为 lanes + kernel_size - 1
+// 越界的像素按 0 读入并且不计入权重和，与 device_convolution 跳过越界点再归一化等价
+// 输入有几个平面就计算几个，不透明图像只有 R、G、B 三个平面，alpha 不参与计算
+// hint: 求和顺序与 device_convolution 不同，取整后可能相差 1
+template <int kernel_size, typename TI, typename TO>
+double device_planar_convolution(sycl::queue &queue, sycl::buffer<TI, 3> &buffer_input, 
+                                 sycl::buffer<TO, 3> &buffer_output, sycl::buffer<float, 2> &buffer_kernel, 
+                                 const my::kernel<float, kernel_size> &) {
+    using lanes_t = sycl::vec<float, planar_lanes>;
+    constexpr int kernel_offset = kernel_size / 2, window = planar_lanes + kernel_size - 1;
+    const auto range = buffer_input.get_range();
+    const int planes = range[0], height = range[1], width = range[2];
+    auto event = queue.submit([&](sycl::handler& cgh) {
+        auto accessor_input = buffer_input.template get_access<sycl::access::mode::read>(cgh);
+        auto accessor_output = buffer_output.template get_access<sycl::access::mode::write>(cgh);
+        auto accessor_kernel = buffer_kernel.get_access<sycl::access::mode::read>(cgh);
+        sycl::range<3> global(planes, height, (width + planar_lanes - 1) / planar_lanes);
+        cgh.parallel_for<PlanarConvolutionKernel<kernel_size, TI, TO>>(global, [=](sycl::item<3> item) {
+            const int c = item.get_id(0), y = item.get_id(1), x0 = item.get_id(2) * planar_lanes;
+            lanes_t sum(0.f), sum_weight(0.f);
+            for (int j = 0; j < kernel_size; ++j) {
+                int inputY = y + j - kernel_offset;
+                if (inputY < 0 || inputY >= height) continue;
+                float values[window], valid[window];
+                for (int t = 0; t < window; ++t) {
+                    int inputX = x0 + t - kernel_offset;
+                    bool inside = inputX >= 0 && inputX < width;
+                    values[t] = inside ? float(accessor_input[{(unsigned)c, (unsigned)inputY, (unsigned)inputX}]) : 0.f;
+                    valid[t] = inside ? 1.f : 0.f;
+                }
+                for (int i = 0; i < kernel_size; ++i) {
+                    lanes_t value, mask;
+                    for (int l = 0; l < planar_lanes; ++l)
+                        value[l] = values[i + l], mask[l] = valid[i + l];
+                    auto weight = accessor_kernel[{(unsigned)i, (unsigned)j}];
+                    sum += value * weight;
+                    sum_weight += mask * weight;
+                }
+            }
+            for (int l = 0; l < planar_lanes && x0 + l < width; ++l) {
+                float result = sum[l] / sum_weight[l];
+                if constexpr (std::is_floating_point_v<TO>)
+                    accessor_output[{(unsigned)c, (unsigned)y, (unsigned)(x0 + l)}] = result;
+                else
+                    accessor_output[{(unsigned)c, (unsigned)y, (unsigned)(x0 + l)}] = 
+                        static_cast<TO>(std::clamp(std::round(result), 0.f, 255.f));
+            }
+        });
+    });
+    return event_duration(event);
+}
+
+// 每一维的最大 FFT 长度：图像加上卷积核延伸的部分超过它时按 overlap-add 分块
+constexpr int fft_max_tile = 1024;
+
+// 一批一维 FFT 的数据布局：第 b 个变换的第 t 个元素位于
+// (b / inner) * outer_stride + (b % inner) * inner_stride + t * element_stride
+struct fft_layout {
+    int batch, inner, inner_stride, outer_stride, element_stride;
+};
+
+// Stockham FFT 的一级：每个 work-item 取间隔 n / radix 的 radix 个元素，乘以旋转因子后做一次 radix 点 DFT，
+// 写到输出中间隔 span 的位置（span 为之前各级的基之积）；各级结束后输出即为自然顺序，不需要位反转重排
+sycl::event fft_stage(sycl::queue &queue, sycl::buffer<sycl::float2> &src, sycl::buffer<sycl::float2> &dst,
+                      const fft_layout &layout, int n, int radix, int span, float direction) {
+    return queue.submit([&](sycl::handler& cgh) {
+        auto accessor_src = src.get_access<sycl::access::mode::read>(cgh);
+        auto accessor_dst = dst.get_access<sycl::access::mode::write>(cgh);
+        // hint: 让相邻的 work-item 访问相邻的元素：行变换沿变换方向排列，列变换沿批次方向排列
+        const bool batch_inner = layout.element_stride != 1;
+        const int butterflies = n / radix;
+        auto range = batch_inner ? sycl::range<2>(butterflies, layout.batch) : sycl::range<2>(layout.batch, butterflies);
+        cgh.parallel_for(range, [=](sycl::item<2> item) {
+            const int b = batch_inner ? item.get_id(1) : item.get_id(0);
+            const int j = batch_inner ? item.get_id(0) : item.get_id(1);
+            const int base = b / layout.inner * layout.outer_stride + b % layout.inner * layout.inner_stride;
+            const int k = j % span;
+            sycl::float2 v[my::fft_max_radix];
+            for (int r = 0; r < radix; ++r)
+                v[r] = my::complex_mul(accessor_src[base + (j + r * butterflies) * layout.element_stride],
+                                       my::twiddle(direction * float(k * r) / float(span * radix)));
+            my::fft_butterfly(v, radix, direction);
+            const int out = j / span * span * radix + k;
+            for (int r = 0; r < radix; ++r)
+                accessor_dst[base + (out + r * span) * layout.element_stride] = v[r];
+        });
+    });
+}
+
+// 对 planes 个 rows x cols 的复数平面（行主序，依次存放）做二维 FFT：先对各行、再对各列做一维 FFT
+// 每一级在 data 与 temp 之间交替，两者的句柄随之交换，返回时结果总在 data 中；direction 为 1 时是不含缩放的逆变换
+void fft_2d(sycl::queue &queue, sycl::buffer<sycl::float2> &data, sycl::buffer<sycl::float2> &temp, 
+            int planes, int rows, int cols, float direction, std::vector<sycl::event> &events) {
+    auto pass = [&](const my::fft_plan &plan, const fft_layout &layout) {
+        int span = 1;
+        for (int radix : plan.radices) {
+            events.push_back(fft_stage(queue, data, temp, layout, plan.size, radix, span, direction));
+            std::swap(data, temp);
+            span *= radix;
+        }
+    };
+    pass(my::fft_plan(cols), fft_layout{planes * rows, planes * rows, cols, 0, 1});
+    pass(my::fft_plan(rows), fft_layout{planes * cols, cols, 1, rows * cols, cols});
+}
+
+// FFT 卷积：卷积核补零后的频谱只计算一次；图像按 overlap-add 分块，每块把 (r, g)、(b, a) 分别作为实部与虚部，
+// 加上图像内为 1 的掩码，共 3 个复数平面做正变换、与核频谱逐点相乘、逆变换，
+// 结果连同延伸到块外 kernel_size / 2 的部分累加到整幅图像上
+// 掩码卷积后是每个像素上有效权重之和，最后逐像素相除，与 device_convolution 跳过越界点再归一化的结果一致
+// hint: 卷积核是实数，实部与虚部的卷积互不混合，两个通道可以共用一次复数 FFT
+template <int kernel_size>
+double device_fft_convolution(sycl::queue &queue, sycl::buffer<my::pixel_rgba, 2> &buffer_input, 
+                              sycl::buffer<my::pixel_rgba, 2> &buffer_output, int width, int height,
+                              const my::kernel<float, kernel_size> &kernel, int max_fft = fft_max_tile) {
+    constexpr int kernel_offset = kernel_size / 2, planes = 3;
+    // 整幅图像放得下时每一维只有一块，否则块长为 max_fft 减去卷积核延伸的部分
+    auto block_size = [&](int length) {
+        return length + kernel_size - 1 <= max_fft ? length : max_fft - (kernel_size - 1);
+    };
+    const int block_rows = block_size(height), block_cols = block_size(width);
+    if (block_rows <= 0 || block_cols <= 0)
+        throw std::runtime_error("Convolution kernel is too large for the FFT tile");
+    const int rows = my::fft_size(block_rows + kernel_size - 1), cols = my::fft_size(block_cols + kernel_size - 1);
+    const int plane = rows * cols;
+    const float scale = 1.f / float(plane);
+
+    // 输出 (y, x) 取输入 (y + j - offset, x + i - offset)，即与 h(offset - j, offset - i) = data[i][j] 做卷积，
+    // 负的下标循环到平面的末尾；平面长度不小于块长加上 kernel_size - 1，循环卷积不会混叠
+    std::vector<sycl::float2> kernel_plane(plane, sycl::float2(0.f, 0.f));
+    for (int i = 0; i < kernel_size; ++i)
+        for (int j = 0; j < kernel_size; ++j)
+            kernel_plane[(kernel_offset - j + rows) % rows * cols + (kernel_offset - i + cols) % cols] = 
+                sycl::float2(kernel.data[i * kernel_size + j], 0.f);
+
+    std::vector<sycl::event> events;
+    sycl::buffer<sycl::float2> buffer_spectrum(kernel_plane.data(), sycl::range<1>(plane));
+    sycl::buffer<sycl::float2> buffer_spectrum_temp{sycl::range<1>(plane)};
+    fft_2d(queue, buffer_spectrum, buffer_spectrum_temp, 1, rows, cols, -1.f, events);
+
+    sycl::buffer<sycl::float2> buffer_planes(sycl::range<1>(planes * plane)), buffer_temp(sycl::range<1>(planes * plane));
+    sycl::buffer<sycl::float4, 2> buffer_sum(sycl::range<2>(height, width));
+    sycl::buffer<float, 2> buffer_weight(sycl::range<2>(height, width));
+    events.push_back(queue.submit([&](sycl::handler& cgh) {
+        auto accessor_sum = buffer_sum.get_access<sycl::access::mode::write>(cgh);
+        auto accessor_weight = buffer_weight.get_access<sycl::access::mode::write>(cgh);
+        cgh.parallel_for(sycl::range<2>(height, width), [=](sycl::item<2> item) {
+            accessor_sum[item] = sycl::float4(0.f);
+            accessor_weight[item] = 0.f;
+        });
+    }));
+
+    for (int y0 = 0; y0 < height; y0 += block_rows) {
+        for (int x0 = 0; x0 < width; x0 += block_cols) {
+            const int by = std::min(block_rows, height - y0), bx = std::min(block_cols, width - x0);
+            events.push_back(queue.submit([&](sycl::handler& cgh) {
+                auto accessor_input = buffer_input.get_access<sycl::access::mode::read>(cgh);
+                auto accessor_planes = buffer_planes.get_access<sycl::access::mode::write>(cgh);
+                cgh.parallel_for(sycl::range<2>(rows, cols), [=](sycl::item<2> item) {
+                    int y = item.get_id(0);
+                    int x = item.get_id(1);
+                    sycl::float2 rg(0.f, 0.f), ba(0.f, 0.f), mask(0.f, 0.f);
+                    if (y < by && x < bx) {
+                        auto pixel = accessor_input[{(unsigned)(y0 + y), (unsigned)(x0 + x)}];
+                        rg = sycl::float2(float(pixel.r), float(pixel.g));
+                        ba = sycl::float2(float(pixel.b), float(pixel.a));
+                        mask = sycl::float2(1.f, 0.f);
+                    }
+                    const int e = y * cols + x;
+                    accessor_planes[e] = rg;
+                    accessor_planes[plane + e] = ba;
+                    accessor_planes[2 * plane + e] = mask;
+                });
+            }));
+            fft_2d(queue, buffer_planes, buffer_temp, planes, rows, cols, -1.f, events);
+            events.push_back(queue.submit([&](sycl::handler& cgh) {
+                auto accessor_planes = buffer_planes.get_access<sycl::access::mode::read_write>(cgh);
+                auto accessor_spectrum = buffer_spectrum.get_access<sycl::access::mode::read>(cgh);
+                cgh.parallel_for(sycl::range<1>(plane), [=](sycl::item<1> item) {
+                    const int e = item.get_id(0);
+                    auto s = accessor_spectrum[e] * scale;
+                    for (int p = 0; p < planes; ++p)
+                        accessor_planes[p * plane + e] = my::complex_mul(accessor_planes[p * plane + e], s);
+                });
+            }));
+            fft_2d(queue, buffer_planes, buffer_temp, planes, rows, cols, 1.f, events);
+            // overlap-add：块的卷积结果覆盖块外 kernel_size / 2 的范围，相邻块的结果在此相加
+            // hint: 各块的 kernel 按提交顺序依次执行，同一个 kernel 内每个像素只被一个 work-item 累加
+            events.push_back(queue.submit([&](sycl::handler& cgh) {
+                auto accessor_planes = buffer_planes.get_access<sycl::access::mode::read>(cgh);
+                auto accessor_sum = buffer_sum.get_access<sycl::access::mode::read_write>(cgh);
+                auto accessor_weight = buffer_weight.get_access<sycl::access::mode::read_write>(cgh);
+                cgh.parallel_for(sycl::range<2>(by + kernel_size - 1, bx + kernel_size - 1), [=](sycl::item<2> item) {
+                    int ly = (int)item.get_id(0) - kernel_offset;
+                    int lx = (int)item.get_id(1) - kernel_offset;
+                    int y = y0 + ly, x = x0 + lx;
+                    if (x < 0 || x >= width || y < 0 || y >= height) return;
+                    const int e = (ly + rows) % rows * cols + (lx + cols) % cols;
+                    auto rg = accessor_planes[e], ba = accessor_planes[plane + e];
+                    accessor_sum[{(unsigned)y, (unsigned)x}] += sycl::float4(rg[0], rg[1], ba[0], ba[1]);
+                    accessor_weight[{(unsigned)y, (unsigned)x}] += accessor_planes[2 * plane + e][0];
+                });
+            }));
+        }
+    }
+
+    events.push_back(queue.submit([&](sycl::handler& cgh) {
+        auto accessor_sum = buffer_sum.get_access<sycl::access::mode::read>(cgh);
+        auto accessor_weight = buffer_weight.get_access<sycl::access::mode::read>(cgh);
+        auto accessor_output = buffer_output.get_access<sycl::access::mode::write>(cgh);
+        cgh.parallel_for(sycl::range<2>(height, width), [=](sycl::item<2> item) {
+            auto sum = accessor_sum[item] * (1.f / accessor_weight[item]);
+            accessor_output[item] = my::make_pixel_rgba(sum[0], sum[1], sum[2], sum[3]);
+        });
+    }));
+    double duration = 0;
+    for (auto &event : events)
+        duration += event_duration(event);
+    return duration;
+}
+
+// 依次测量候选边长的均值卷积核上直接卷积与 FFT 卷积的耗时（各预热一次），返回第一个 FFT 更快的边长
+// hint: 直接卷积的耗时随 kernel_size^2 增长，FFT 卷积基本不变；候选范围内 FFT 都不更快时认为交叉点在范围之外
+template <int size, int... sizes>
+int measure_fft_crossover(sycl::queue &queue, sycl::buffer<my::pixel_rgba, 2> &buffer_input, 
+                          sycl::buffer<my::pixel_rgba, 2> &buffer_output, int width, int height) {
+    my::kernel<float, size> kernel(1.f);
+    kernel.normalize();
+    sycl::buffer<float, 2> buffer_kernel(kernel.get_data(), sycl::range<2>(size, size));
+    device_convolution(queue, buffer_input, buffer_output, buffer_kernel, width, height, kernel);
+    auto direct = device_convolution(queue, buffer_input, buffer_output, buffer_kernel, width, height, kernel);
+    device_fft_convolution(queue, buffer_input, buffer_output, width, height, kernel);
+    auto fft = device_fft_convolution(queue, buffer_input, buffer_output, width, height, kernel);
+    std::cout << "  " << size << "x" << size << ": direct " << direct << "ms, FFT " << fft << "ms" << std::endl;
+    if (fft < direct)
+        return size;
+    if constexpr (sizeof...(sizes) == 0)
+        return size + 2;
+    else
+        return measure_fft_crossover<sizes...>(queue, buffer_input, buffer_output, width, height);
+}
+
+// 直接卷积与 FFT 卷积的交叉点：卷积核边长不小于它时使用 FFT；按设备与图像规模缓存在调优文件中，未缓存时测量
+int fft_crossover(sycl::queue &queue, sycl::buffer<my::pixel_rgba, 2> &buffer_input, int width, int height) {
+    auto device = queue.get_device();
+    my::device_info info{device.get_info<sycl::info::device::name>(), device};
+    auto key = "convolution_fft/" + my::size_bucket({std::size_t(height), std::size_t(width)});
+    my::tuning_cache cache;
+    if (auto cached = cache.find(info, key); cached.has_value()) {
+        std::cout << "  FFT crossover (cached): " << *cached << std::endl;
+        return std::stoi(*cached);
+    }
+    std::cout << "  Measuring FFT crossover for " << info.name << " (" << key << ")..." << std::endl;
+    sycl::buffer<my::pixel_rgba, 2> buffer_output(sycl::range<2>(height, width));
+    auto crossover = measure_fft_crossover<3, 5, 7, 11, 15, 19, 25, 31, 41, 51, 63>(queue, buffer_input, buffer_output, 
+                                                                                     width, height);
+    cache.store(info, key, std::to_string(crossover));
+    std::cout << "  FFT crossover: " << crossover << std::endl;
+    return crossover;
+}
+
+// 自动选择卷积路径：查询一次 fft_crossover，卷积核边长不小于交叉点时运行 FFT 卷积，否则运行直接卷积
+// 返回所选路径的 kernel 耗时（ms）；首次在某个设备与图像规模上调用时包含交叉点的测量
+template <int kernel_size>
+double device_auto_convolution(sycl::queue &queue, sycl::buffer<my::pixel_rgba, 2> &buffer_input, 
+                               sycl::buffer<my::pixel_rgba, 2> &buffer_output, int width, int height,
+                               my::kernel<float, kernel_size> kernel) {
+    auto crossover = fft_crossover(queue, buffer_input, width, height);
+    auto use_fft = kernel_size >= crossover;
+    std::cout << "  Dispatch: " << kernel_size << "x" << kernel_size << " kernel, crossover " << crossover 
+              << ", using " << (use_fft ? "FFT" : "direct") << " convolution" << std::endl;
+    if (use_fft)
+        return device_fft_convolution(queue, buffer_input, buffer_output, width, height, kernel);
+    sycl::buffer<float, 2> buffer_kernel(kernel.get_data(), sycl::range<2>(kernel_size, kernel_size));
+    return device_convolution(queue, buffer_input, buffer_output, buffer_kernel, width, height, kernel);
+}
+
+// 两幅图像各通道的最大差值
+int max_difference(const my::image_data_rgba &a, const my::image_data_rgba &b) {
+    int difference = 0;
+    for (std::size_t i = 0; i < a.size(); i++)
+        for (int c = 0; c < 4; c++)
+            difference = std::max(difference, std::abs(int(a[i].data[c]) - int(b[i].data[c])));
+    return difference;
+}
+
+// 以给定的卷积核处理图像，比较 device 与 host 的结果和耗时；再依次运行 local memory 分块、FFT、
+// 按交叉点自动选择的卷积与平面图像（uint8 / float）的卷积，各自与直接卷积的结果比较；
+// 卷积核可分离时最后比较两趟一维卷积（device 与 host）和二维卷积的结果
+template <typename Kernel>
+int convolve(Kernel kernel) {
     // 图像参数
     // todo: 使用 sycl 提供的图像类和 host 图像类
     constexpr auto filename = workspace_root "img/IMG_2881.JPG";
@@ -105,12 +578,6 @@ int main() {
     auto input = img.get_data_rgba();
     std::cout << "Image size: " << width << " * " << height << std::endl;
 
-    // 卷积核
-    // my::gaussian_kernel<float, 19> kernel;
-    // my::kernel<float, 11> kernel(1.f);
-    my::sharpen_kernel<float, 3> kernel(12);
-    kernel.normalize();
-
     // 输出图像
     my::image_data_rgba output(width * height);
 
@@ -175,5 +642,182 @@ int main() {
     } else {
         std::cout << "Host Convolution result is not the same as Device Convolution result." << std::endl;
     }
+
+    std::cout << "\nTiled Convolution (" << convolution_tile << "x" << convolution_tile 
+              << " tile with halo in local memory)..." << std::endl;
+    my::image_data_rgba tiled_output(width * height);
+    double tiled_duration = 0;
+    try {
+        sycl::queue queue(sycl::default_selector_v, my::prop_list);
+        sycl::buffer<my::pixel_rgba, 2> buffer_input(input.data(), sycl::range<2>(height, width));
+        sycl::buffer<my::pixel_rgba, 2> buffer_output(tiled_output.data(), sycl::range<2>(height, width));
+        sycl::buffer<float, 2> buffer_kernel(kernel.get_data(), sycl::range<2>(kernel.get_size(), kernel.get_size()));
+        tiled_duration = device_tiled_convolution(queue, buffer_input, buffer_output, buffer_kernel, width, height, 
+                                                  kernel);
+    } catch (sycl::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    std::cout << "  Time (kernel): " << tiled_duration << "ms, 2D " << kernel_duration << "ms, speedup " 
+              << kernel_duration / tiled_duration << std::endl;
+    if (max_difference(tiled_output, output) == 0) {
+        std::cout << "Tiled Convolution result is the same as Device Convolution result." << std::endl;
+    } else {
+        std::cout << "Tiled Convolution result is not the same as Device Convolution result." << std::endl;
+    }
+
+    std::cout << "\nFFT Convolution..." << std::endl;
+    my::image_data_rgba fft_output(width * height);
+    double fft_duration = 0;
+    try {
+        sycl::queue queue(sycl::default_selector_v, my::prop_list);
+        sycl::buffer<my::pixel_rgba, 2> buffer_input(input.data(), sycl::range<2>(height, width));
+        sycl::buffer<my::pixel_rgba, 2> buffer_output(fft_output.data(), sycl::range<2>(height, width));
+        fft_duration = device_fft_convolution(queue, buffer_input, buffer_output, width, height, kernel);
+    } catch (sycl::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    std::cout << "  Time (kernel): " << fft_duration << "ms, 2D " << kernel_duration << "ms, speedup " 
+              << kernel_duration / fft_duration << std::endl;
+    // hint: FFT 的舍入误差与直接求和不同，取整后允许相差 1
+    auto fft_difference = max_difference(fft_output, output);
+    std::cout << "  Max difference from 2D result: " << fft_difference << std::endl;
+    if (fft_difference <= 1) {
+        std::cout << "FFT Convolution result matches Device Convolution result." << std::endl;
+    } else {
+        std::cout << "FFT Convolution result does not match Device Convolution result." << std::endl;
+    }
+
+    std::cout << "\nAutomatic Convolution (FFT from the measured crossover on)..." << std::endl;
+    my::image_data_rgba auto_output(width * height);
+    double auto_duration = 0, auto_kernel_duration = 0;
+    try {
+        sycl::queue queue(sycl::default_selector_v, my::prop_list);
+        sycl::buffer<my::pixel_rgba, 2> buffer_input(input.data(), sycl::range<2>(height, width));
+        sycl::buffer<my::pixel_rgba, 2> buffer_output(auto_output.data(), sycl::range<2>(height, width));
+        auto start_auto_timer = std::chrono::steady_clock::now();
+        auto_kernel_duration = device_auto_convolution(queue, buffer_input, buffer_output, width, height, kernel);
+        auto end_auto_timer = std::chrono::steady_clock::now();
+        auto_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_auto_timer - start_auto_timer).count();
+    } catch (sycl::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    std::cout << "  Time (device): " << auto_duration << "ms" << std::endl;
+    std::cout << "  Time (kernel): " << auto_kernel_duration << "ms, 2D " << kernel_duration << "ms, speedup " 
+              << kernel_duration / auto_kernel_duration << std::endl;
+    if (max_difference(auto_output, output) <= 1) {
+        std::cout << "Automatic Convolution result matches Device Convolution result." << std::endl;
+    } else {
+        std::cout << "Automatic Convolution result does not match Device Convolution result." << std::endl;
+    }
+
+    // 平面图像：从 my::image 直接拆分为 uint8 与 float 两种存储，各运行一次平面卷积
+    start_host_timer = std::chrono::steady_clock::now();
+    my::planar_image<std::uint8_t> planar_u8(img);
+    auto split_timer = std::chrono::steady_clock::now();
+    my::planar_image<float> planar_f32(img);
+    end_host_timer = std::chrono::steady_clock::now();
+    std::cout << "\nPlanar Convolution (" << planar_u8.planes() << " planes" 
+              << (planar_u8.opaque() ? ", opaque image skips alpha" : "") << ", " << planar_lanes << " pixels per item)..." 
+              << std::endl;
+    std::cout << "  Split (uint8): " 
+              << std::chrono::duration_cast<std::chrono::microseconds>(split_timer - start_host_timer).count() << "us, "
+              << "(float): " 
+              << std::chrono::duration_cast<std::chrono::microseconds>(end_host_timer - split_timer).count() << "us" 
+              << std::endl;
+    auto planar_convolution = [&](auto &planar_input, const char *type) {
+        using T = std::remove_reference_t<decltype(*planar_input.data())>;
+        my::planar_image<T> planar_output(width, height, planar_input.planes());
+        double duration = 0;
+        {
+            sycl::queue queue(sycl::default_selector_v, my::prop_list);
+            auto buffer_input = planar_input.buffer();
+            auto buffer_output = planar_output.buffer();
+            sycl::buffer<float, 2> buffer_kernel(kernel.get_data(), sycl::range<2>(kernel.get_size(), kernel.get_size()));
+            duration = device_planar_convolution(queue, buffer_input, buffer_output, buffer_kernel, kernel);
+        }
+        auto difference = max_difference(planar_output.to_rgba(), output);
+        std::cout << "  Time (kernel, " << type << "): " << duration << "ms, 2D " << kernel_duration << "ms, speedup " 
+                  << kernel_duration / duration << ", max difference from 2D result: " << difference << std::endl;
+        return difference;
+    };
+    try {
+        auto u8_difference = planar_convolution(planar_u8, "uint8");
+        auto f32_difference = planar_convolution(planar_f32, "float");
+        // hint: 求和顺序不同，取整后允许相差 1
+        if (std::max(u8_difference, f32_difference) <= 1) {
+            std::cout << "Planar Convolution result matches Device Convolution result." << std::endl;
+        } else {
+            std::cout << "Planar Convolution result does not match Device Convolution result." << std::endl;
+        }
+    } catch (sycl::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+
+    auto factors = kernel.separate();
+    if (!factors.has_value()) {
+        std::cout << "\nConvolution kernel is not separable." << std::endl;
+        return 0;
+    }
+    const auto kernel_size = kernel.get_size();
+    std::cout << "\nSeparable Convolution (" << 2 * kernel_size << " taps per pixel instead of " 
+              << kernel_size * kernel_size << ")..." << std::endl;
+    my::image_data_rgba separable_output(width * height);
+    double separable_duration = 0;
+    try {
+        sycl::queue queue(sycl::default_selector_v, my::prop_list);
+        sycl::buffer<my::pixel_rgba, 2> buffer_input(input.data(), sycl::range<2>(height, width));
+        sycl::buffer<my::pixel_rgba, 2> buffer_output(separable_output.data(), sycl::range<2>(height, width));
+        separable_duration = device_separable_convolution(queue, buffer_input, buffer_output, width, height, *factors);
+    } catch (sycl::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    start_host_timer = std::chrono::steady_clock::now();
+    auto separable_host_output = host_separable_convolution(width, height, input, *factors, true);
+    end_host_timer = std::chrono::steady_clock::now();
+    std::cout << "  Time (kernel): " << separable_duration << "ms, 2D " << kernel_duration << "ms, speedup " 
+              << kernel_duration / separable_duration << std::endl;
+    std::cout << "  Time (host): " 
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end_host_timer - start_host_timer).count() << "ms" 
+              << std::endl;
+    // hint: 两条路径的浮点舍入不同，取整后允许相差 1
+    auto difference = std::max(max_difference(separable_output, host_output), 
+                               max_difference(separable_host_output, host_output));
+    std::cout << "  Max difference from 2D result: " << difference << std::endl;
+    if (difference <= 1) {
+        std::cout << "Separable Convolution result matches 2D Convolution result." << std::endl;
+    } else {
+        std::cout << "Separable Convolution result does not match 2D Convolution result." << std::endl;
+    }
     return 0;
 }
+
+// 通过命令行参数选择卷积核：gaussian（19x19 高斯）、blur（31x31 高斯）、box（11x11 均值）、sharpen（3x3 锐化，默认），
+// all 依次运行全部，比较卷积核大小为 3、11、19、31 时各路径的耗时
+int main(int argc, char *argv[]) {
+    std::string name = argc > 1 ? argv[1] : "sharpen";
+    if (name != "sharpen" && name != "box" && name != "gaussian" && name != "blur" && name != "all") {
+        std::cout << "Usage: " << argv[0] << " [sharpen|box|gaussian|blur|all]" << std::endl;
+        return 1;
+    }
+    int result = 0;
+    if (name == "sharpen" || name == "all") {
+        my::sharpen_kernel<float, 3> kernel(12);
+        kernel.normalize();
+        result |= convolve(kernel);
+    }
+    if (name == "box" || name == "all") {
+        my::kernel<float, 11> kernel(1.f);
+        kernel.normalize();
+        result |= convolve(kernel);
+    }
+    if (name == "gaussian" || name == "all")
+        result |= convolve(my::gaussian_kernel<float, 19>());
+    if (name == "blur" || name == "all")
+        result |= convolve(my::gaussian_kernel<float, 31>());
+    return result;
+}
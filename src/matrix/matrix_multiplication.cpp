@@ -1,8 +1,16 @@
 #include <sycl/sycl.hpp>
+#include <functional>
 #include <iostream>
+#include <list>
 
 #include "my.hpp"
+#include "my/mapped.hpp"
 #include "my/mat.hpp"
+#include "my/mat_io.hpp"
+#include "my/quant.hpp"
+#include "my/sparse.hpp"
+#include "my/tune.hpp"
+#include "my/verify.hpp"
 
 constexpr auto matrix_unit_size = 16;
 constexpr auto matrix_size = 1024;
@@ -10,6 +18,38 @@ constexpr auto M = matrix_size;
 constexpr auto N = matrix_size;
 constexpr auto P = matrix_size;       
 
+// 寄存器分块 kernel 中每个 work-item 负责的 C 子块大小
+constexpr auto micro_tile_m = 4;
+constexpr auto micro_tile_n = 4;
+
+// 批量 GEMM 基准的批大小与每个矩阵的边长
+constexpr auto batch_count = 1024;
+constexpr auto batch_matrix_size = 64;
+
+// 稀疏矩阵基准中 A 的边长与 SpMM 中 B 的列数
+constexpr auto sparse_matrix_size = 4096;
+constexpr auto sparse_columns = 64;
+
+// 转置带宽基准的默认矩阵大小
+constexpr auto transpose_size = 8192;
+
+// 外存 GEMM 的默认方阵边长与流经 device 的分块边长
+constexpr std::size_t out_of_core_size = 16384;
+constexpr std::size_t out_of_core_block = 2048;
+
+// Strassen–Winograd 模式的默认截断：子问题的边长均不超过它时改用 tiled kernel 计算
+constexpr std::size_t strassen_cutoff = 512;
+
+// 由 kernel 耗时（ms）计算达到的 GFLOP/s
+double gflops(double duration, double m = M, double n = N, double p = P) {
+    return 2.0 * m * n * p / (duration * 1e6);
+}
+
+// 向上取整到 unit 的倍数，用于把任意大小的问题补齐到整数个 work-group
+constexpr std::size_t round_up(std::size_t x, std::size_t unit = matrix_unit_size) {
+    return (x + unit - 1) / unit * unit;
+}
+
 double kernel(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float, 2> &b_buf, 
             sycl::buffer<float, 2> &c_buf) {
     auto mm = q.submit([&](sycl::handler &h) {
@@ -19,7 +59,7 @@ double kernel(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float,
 
         int a_width = a.get_range()[1];
 
-        h.parallel_for(sycl::range(M, P), [=](sycl::id<2> index) {
+        h.parallel_for(c.get_range(), [=](sycl::id<2> index) {
             float sum = 0;
             auto row = index[0], col = index[1];
             for (int i = 0; i < a_width; i++) {
@@ -35,14 +75,17 @@ double kernel(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float,
     return (end - start) * 1e-6;
 }
 
-double kernel2(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float, 2> &b_buf, 
-            sycl::buffer<float, 2> &c_buf) {
+// 操作数可以是整个 buffer，也可以是 buffer 中的子矩阵（my::buffer_view），子矩阵通过 ranged accessor 访问
+double kernel2(sycl::queue &q, my::buffer_view<float> a_view, my::buffer_view<float> b_view, 
+            my::buffer_view<float> c_view) {
+    // hint: 尺寸不是 matrix_unit_size 的倍数时，越界的 work-item 向 local tile 填 0 并且不写回
+    std::size_t m = c_view.rows(), n = a_view.cols(), p = c_view.cols();
     sycl::range<2> local_size(matrix_unit_size, matrix_unit_size);
-    sycl::range<2> global_size(M, P);
+    sycl::range<2> global_size(round_up(m), round_up(p));
     auto mm = q.submit([&](sycl::handler &h) {
-        sycl::accessor a(a_buf, h, sycl::read_only);
-        sycl::accessor b(b_buf, h, sycl::read_only);
-        sycl::accessor c(c_buf, h, sycl::read_write);
+        auto a = a_view.access(h, sycl::read_only);
+        auto b = b_view.access(h, sycl::read_only);
+        auto c = c_view.access(h, sycl::read_write);
 
         sycl::local_accessor<float, 2> a_t(sycl::range<2>(matrix_unit_size, matrix_unit_size), h);
         sycl::local_accessor<float, 2> b_t(sycl::range<2>(matrix_unit_size, matrix_unit_size), h);
@@ -51,20 +94,21 @@ double kernel2(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float
             auto local_row = item.get_local_id(0), local_col = item.get_local_id(1);
             auto global_row = item.get_group(0) * matrix_unit_size + local_row;
             auto global_col = item.get_group(1) * matrix_unit_size + local_col;
-            auto tiles = matrix_size / matrix_unit_size;
+            auto tiles = round_up(n) / matrix_unit_size;
             float acc = 0;
-            for (int i = 0; i < tiles; i++) {
+            for (std::size_t i = 0; i < tiles; i++) {
                 auto tile_col = i * matrix_unit_size + local_col;
                 auto tile_row = i * matrix_unit_size + local_row;
-                a_t[local_row][local_col] = a[global_row][tile_col];
-                b_t[local_row][local_col] = b[tile_row][global_col];
+                a_t[local_row][local_col] = global_row < m && tile_col < n ? a[global_row][tile_col] : 0.f;
+                b_t[local_row][local_col] = tile_row < n && global_col < p ? b[tile_row][global_col] : 0.f;
                 item.barrier(sycl::access::fence_space::local_space);
                 for (int j = 0; j < matrix_unit_size; j++) {
                     acc += a_t[local_row][j] * b_t[j][local_col];
                 }
                 item.barrier(sycl::access::fence_space::local_space);
             }
-            c[global_row][global_col] = acc;
+            if (global_row < m && global_col < p)
+                c[global_row][global_col] = acc;
         });   
     });    
 
@@ -73,101 +117,2135 @@ double kernel2(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float
     auto end = mm.get_profiling_info<sycl::info::event_profiling::command_end>();
     return (end - start) * 1e-6;
 }
+
+// 把 C 等分为 2x2 块，每块由一次 kernel2 计算 C_ij = A_i * B_j；A_i、B_j、C_ij 都是原 buffer 中的子矩阵视图，
+// 不复制、不分配临时存储，演示分块算法如何直接在视图上调用 kernel
+double blocked_views(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float, 2> &b_buf, 
+                     sycl::buffer<float, 2> &c_buf) {
+    my::buffer_view<float> a(a_buf), b(b_buf), c(c_buf);
+    const std::size_t m = c.rows(), n = a.cols(), p = c.cols();
+    const std::size_t rows[] = {0, m / 2, m}, cols[] = {0, p / 2, p};
+    double duration = 0;
+    for (int i = 0; i < 2; i++)
+        for (int j = 0; j < 2; j++) {
+            auto height = rows[i + 1] - rows[i], width = cols[j + 1] - cols[j];
+            if (height == 0 || width == 0) continue;
+            duration += kernel2(q, a.block(rows[i], 0, height, n), b.block(0, cols[j], n, width),
+                                c.block(rows[i], cols[j], height, width));
+        }
+    return duration;
+}
+
+// 双缓冲的 kernel2：local memory 中保留两组 tile，计算第 i 个 tile 的同时读入第 i + 1 个 tile，
+// 每个 tile 只需一次 barrier（kernel2 需要两次）
+// hint: 写入的槽位在上一轮被读取，上一轮末尾的 barrier 保证所有 work-item 都已读完
+double kernel2_double_buffered(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float, 2> &b_buf, 
+            sycl::buffer<float, 2> &c_buf) {
+    std::size_t m = c_buf.get_range()[0], n = a_buf.get_range()[1], p = c_buf.get_range()[1];
+    sycl::range<2> local_size(matrix_unit_size, matrix_unit_size);
+    sycl::range<2> global_size(round_up(m), round_up(p));
+    auto mm = q.submit([&](sycl::handler &h) {
+        sycl::accessor a(a_buf, h, sycl::read_only);
+        sycl::accessor b(b_buf, h, sycl::read_only);
+        sycl::accessor c(c_buf, h, sycl::write_only, sycl::no_init);
+
+        sycl::local_accessor<float, 3> a_t(sycl::range<3>(2, matrix_unit_size, matrix_unit_size), h);
+        sycl::local_accessor<float, 3> b_t(sycl::range<3>(2, matrix_unit_size, matrix_unit_size), h);
+
+        h.parallel_for(sycl::nd_range<2>(global_size, local_size), [=](sycl::nd_item<2> item) {
+            auto local_row = item.get_local_id(0), local_col = item.get_local_id(1);
+            auto global_row = item.get_group(0) * matrix_unit_size + local_row;
+            auto global_col = item.get_group(1) * matrix_unit_size + local_col;
+            auto tiles = round_up(n) / matrix_unit_size;
+            auto load = [&](std::size_t i, std::size_t slot) {
+                auto tile_col = i * matrix_unit_size + local_col;
+                auto tile_row = i * matrix_unit_size + local_row;
+                a_t[slot][local_row][local_col] = global_row < m && tile_col < n ? a[global_row][tile_col] : 0.f;
+                b_t[slot][local_row][local_col] = tile_row < n && global_col < p ? b[tile_row][global_col] : 0.f;
+            };
+            float acc = 0;
+            if (tiles > 0) load(0, 0);
+            item.barrier(sycl::access::fence_space::local_space);
+            for (std::size_t i = 0; i < tiles; i++) {
+                auto slot = i % 2;
+                if (i + 1 < tiles)
+                    load(i + 1, 1 - slot);
+                for (int j = 0; j < matrix_unit_size; j++) {
+                    acc += a_t[slot][local_row][j] * b_t[slot][j][local_col];
+                }
+                item.barrier(sycl::access::fence_space::local_space);
+            }
+            if (global_row < m && global_col < p)
+                c[global_row][global_col] = acc;
+        });   
+    });    
+
+    mm.wait();
+    auto start = mm.get_profiling_info<sycl::info::event_profiling::command_start>();
+    auto end = mm.get_profiling_info<sycl::info::event_profiling::command_end>();
+    return (end - start) * 1e-6;
+}
+
+// 寄存器分块：work-group 仍为 16x16，每个 work-item 在寄存器中累加 TM x TN 个 C 元素，
+// 整个 work-group 负责 (16 * TM) x (16 * TN) 的 C 分块；每个 local 值读入寄存器后参与 TM 或 TN 次乘加
+template <int TM, int TN>
+double kernel3(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float, 2> &b_buf, 
+            sycl::buffer<float, 2> &c_buf) {
+    static_assert(!(M % (matrix_unit_size * TM)), "M must be a multiple of the register block height.");
+    static_assert(!(P % (matrix_unit_size * TN)), "P must be a multiple of the register block width.");
+    constexpr auto block_m = matrix_unit_size * TM;
+    constexpr auto block_n = matrix_unit_size * TN;
+    sycl::range<2> local_size(matrix_unit_size, matrix_unit_size);
+    sycl::range<2> global_size(M / TM, P / TN);
+    auto mm = q.submit([&](sycl::handler &h) {
+        sycl::accessor a(a_buf, h, sycl::read_only);
+        sycl::accessor b(b_buf, h, sycl::read_only);
+        sycl::accessor c(c_buf, h, sycl::write_only, sycl::no_init);
+
+        sycl::local_accessor<float, 2> a_t(sycl::range<2>(block_m, matrix_unit_size), h);
+        sycl::local_accessor<float, 2> b_t(sycl::range<2>(matrix_unit_size, block_n), h);
+
+        h.parallel_for(sycl::nd_range<2>(global_size, local_size), [=](sycl::nd_item<2> item) {
+            auto local_row = item.get_local_id(0), local_col = item.get_local_id(1);
+            auto block_row = item.get_group(0) * block_m;
+            auto block_col = item.get_group(1) * block_n;
+            auto tiles = N / matrix_unit_size;
+            // hint: 子块的行列以 matrix_unit_size 为步长交错分配，相邻 work-item 总是访问相邻地址
+            float acc[TM][TN] = {};
+            float a_r[TM], b_r[TN];
+            for (int i = 0; i < tiles; i++) {
+                auto tile_col = i * matrix_unit_size + local_col;
+                auto tile_row = i * matrix_unit_size + local_row;
+                #pragma unroll
+                for (int r = 0; r < TM; r++)
+                    a_t[r * matrix_unit_size + local_row][local_col] = 
+                        a[block_row + r * matrix_unit_size + local_row][tile_col];
+                #pragma unroll
+                for (int s = 0; s < TN; s++)
+                    b_t[local_row][s * matrix_unit_size + local_col] = 
+                        b[tile_row][block_col + s * matrix_unit_size + local_col];
+                item.barrier(sycl::access::fence_space::local_space);
+                for (int j = 0; j < matrix_unit_size; j++) {
+                    #pragma unroll
+                    for (int r = 0; r < TM; r++)
+                        a_r[r] = a_t[r * matrix_unit_size + local_row][j];
+                    #pragma unroll
+                    for (int s = 0; s < TN; s++)
+                        b_r[s] = b_t[j][s * matrix_unit_size + local_col];
+                    #pragma unroll
+                    for (int r = 0; r < TM; r++)
+                        #pragma unroll
+                        for (int s = 0; s < TN; s++)
+                            acc[r][s] += a_r[r] * b_r[s];
+                }
+                item.barrier(sycl::access::fence_space::local_space);
+            }
+            #pragma unroll
+            for (int r = 0; r < TM; r++)
+                #pragma unroll
+                for (int s = 0; s < TN; s++)
+                    c[block_row + r * matrix_unit_size + local_row][block_col + s * matrix_unit_size + local_col] = acc[r][s];
+        });
+    });
+
+    mm.wait();
+    auto start = mm.template get_profiling_info<sycl::info::event_profiling::command_start>();
+    auto end = mm.template get_profiling_info<sycl::info::event_profiling::command_end>();
+    return (end - start) * 1e-6;
+}
+
+// 子组 GEMM：work-group 为 sub_group_rows x SG，划分为 sub_group_rows 个大小为 SG 的子组；
+// 子组负责 C 中 TM x SG 的分块，lane l 在寄存器中累加第 l 列的 TM 个元素
+// hint: work-item 到子组 lane 的映射由实现决定，分块的位置与 lane 都取自子组的编号，而不是 local id
+// K 方向每次前进 SG：各 lane 按列读入 A 的 TM x SG 小块（每行读取合并），第 kk 步由 lane kk 把它持有的
+// A 值经 select_from_group 广播给整个子组，与各 lane 读入的 B 行相乘；不使用 local memory，没有 barrier
+// hint: 越界的 lane 读入 0 并且不写回，但仍参与广播，子组内所有 lane 必须一起调用 select_from_group
+template <int SG, int TM = 8>
+double subgroup_kernel(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float, 2> &b_buf, 
+            sycl::buffer<float, 2> &c_buf) {
+    constexpr int sub_group_rows = 4;
+    std::size_t m = c_buf.get_range()[0], n = a_buf.get_range()[1], p = c_buf.get_range()[1];
+    sycl::range<2> local_size(sub_group_rows, SG);
+    sycl::range<2> global_size(round_up(round_up(m, TM) / TM, sub_group_rows), round_up(p, SG));
+    auto mm = q.submit([&](sycl::handler &h) {
+        sycl::accessor a(a_buf, h, sycl::read_only);
+        sycl::accessor b(b_buf, h, sycl::read_only);
+        sycl::accessor c(c_buf, h, sycl::write_only, sycl::no_init);
+
+        h.parallel_for(sycl::nd_range<2>(global_size, local_size), [=](sycl::nd_item<2> item) 
+                [[intel::reqd_sub_group_size(SG)]] {
+            auto sg = item.get_sub_group();
+            auto lane = sg.get_local_linear_id();
+            auto first_row = (item.get_group(0) * sub_group_rows + sg.get_group_linear_id()) * TM;
+            auto col = item.get_group(1) * SG + lane;
+            float acc[TM] = {};
+            for (std::size_t k0 = 0; k0 < n; k0 += SG) {
+                float a_reg[TM];
+                for (int r = 0; r < TM; r++)
+                    a_reg[r] = first_row + r < m && k0 + lane < n ? a[first_row + r][k0 + lane] : 0.f;
+                for (int kk = 0; kk < SG; kk++) {
+                    float b_val = k0 + kk < n && col < p ? b[k0 + kk][col] : 0.f;
+                    for (int r = 0; r < TM; r++)
+                        acc[r] += sycl::select_from_group(sg, a_reg[r], kk) * b_val;
+                }
+            }
+            for (int r = 0; r < TM; r++)
+                if (first_row + r < m && col < p)
+                    c[first_row + r][col] = acc[r];
+        });
+    });
+
+    mm.wait();
+    auto start = mm.template get_profiling_info<sycl::info::event_profiling::command_start>();
+    auto end = mm.template get_profiling_info<sycl::info::event_profiling::command_end>();
+    return (end - start) * 1e-6;
+}
+
+// 按设备支持的子组大小选择 subgroup_kernel，依次尝试 16、8、32；都不支持时退回 kernel2
+double subgroup_gemm(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float, 2> &b_buf, 
+            sycl::buffer<float, 2> &c_buf) {
+    auto sizes = q.get_device().get_info<sycl::info::device::sub_group_sizes>();
+    auto supported = [&](std::size_t size) { return std::find(sizes.begin(), sizes.end(), size) != sizes.end(); };
+    for (std::size_t size : {16, 8, 32}) {
+        if (!supported(size)) continue;
+        std::cout << "Sub-group size: " << size << "\n";
+        if (size == 16) return subgroup_kernel<16>(q, a_buf, b_buf, c_buf);
+        if (size == 8) return subgroup_kernel<8>(q, a_buf, b_buf, c_buf);
+        return subgroup_kernel<32>(q, a_buf, b_buf, c_buf);
+    }
+    std::cout << "Sub-group sizes 8 / 16 / 32 are not supported by the device, falling back to the tiled kernel\n";
+    return kernel2(q, a_buf, b_buf, c_buf);
+}
+
+// GEMM 的尾处理：写回前把每个元素的累加结果 acc = (A * B)[row][col] 变换为 C 中的最终值
+// reads_c 为 true 时 kernel 读取 C 中原有的值 c 并传入，否则 c 恒为 0，C 只写不读
+struct store_epilogue {
+    static constexpr bool reads_c = false;
+
+    float operator()(float acc, std::size_t, std::size_t, float) const { return acc; }
+};
+
+enum class bias_kind { none, row, col };
+enum class activation { none, relu, gelu, clamp };
+
+// 融合的尾处理 act(alpha * acc + beta * c + bias)：是否读取 C、偏置的方向与激活函数在编译期确定，kernel 中没有分支
+// 行偏置的长度为 C 的行数，列偏置的长度为 C 的列数；GELU 使用 tanh 近似
+template <bool Beta = false, bias_kind Bias = bias_kind::none, activation Act = activation::none>
+struct gemm_epilogue {
+    static constexpr bool reads_c = Beta;
+    static constexpr bias_kind bias_type = Bias;
+
+    float alpha = 1.f, beta = 0.f;
+    const float *bias = nullptr;
+    float clamp_min = 0.f, clamp_max = 6.f;
+
+    float operator()(float acc, std::size_t row, std::size_t col, float c) const {
+        float x = alpha * acc;
+        if constexpr (Beta) x += beta * c;
+        if constexpr (Bias == bias_kind::row) x += bias[row];
+        if constexpr (Bias == bias_kind::col) x += bias[col];
+        if constexpr (Act == activation::relu) x = sycl::fmax(x, 0.f);
+        if constexpr (Act == activation::gelu) 
+            x = 0.5f * x * (1.f + sycl::tanh(0.7978845608f * (x + 0.044715f * x * x * x)));
+        if constexpr (Act == activation::clamp) x = sycl::clamp(x, clamp_min, clamp_max);
+        return x;
+    }
+};
+
+// 通用 tiled kernel：work-group 为 WM x WN，每个 work-item 计算一个 C 元素，K 方向每次读入 TK 宽的 tile
+// local tile 由整个 work-group 协作读入，因此 tile 形状与 work-group 形状可以不同；任意形状的问题均适用
+// A、B 的存储类型 T 可以是 half / bfloat16，读入 local tile 时转换为 float，并以 float 累加
+// OpA、OpB 为 t 时计算 A^T、B^T 参与的乘积，转置在读入 local tile 时完成，a_buf / b_buf 存放的是未转置的矩阵
+// 写回前对结果应用 epilogue（见 gemm_epilogue），尾处理与乘法在同一个 kernel 中完成，不需要额外遍历 C
+template <int WM, int WN, int TK, typename T = float, my::op OpA = my::op::n, my::op OpB = my::op::n, 
+          typename Epilogue = store_epilogue>
+double tiled_kernel(sycl::queue &q, sycl::buffer<T, 2> &a_buf, sycl::buffer<T, 2> &b_buf, 
+            sycl::buffer<float, 2> &c_buf, Epilogue epilogue = {}) {
+    std::size_t m = c_buf.get_range()[0], p = c_buf.get_range()[1];
+    std::size_t n = a_buf.get_range()[OpA == my::op::n ? 1 : 0];
+    sycl::range<2> local_size(WM, WN);
+    sycl::range<2> global_size(round_up(m, WM), round_up(p, WN));
+    auto mm = q.submit([&](sycl::handler &h) {
+        sycl::accessor a(a_buf, h, sycl::read_only);
+        sycl::accessor b(b_buf, h, sycl::read_only);
+        auto c = [&] {
+            if constexpr (Epilogue::reads_c)
+                return sycl::accessor(c_buf, h, sycl::read_write);
+            else return sycl::accessor(c_buf, h, sycl::write_only, sycl::no_init);
+        }();
+
+        sycl::local_accessor<float, 2> a_t(sycl::range<2>(WM, TK), h);
+        sycl::local_accessor<float, 2> b_t(sycl::range<2>(TK, WN), h);
+
+        h.parallel_for(sycl::nd_range<2>(global_size, local_size), [=](sycl::nd_item<2> item) {
+            auto local_row = item.get_local_id(0), local_col = item.get_local_id(1);
+            auto block_row = item.get_group(0) * WM, block_col = item.get_group(1) * WN;
+            auto global_row = block_row + local_row, global_col = block_col + local_col;
+            auto local_id = item.get_local_linear_id();
+            auto tiles = round_up(n, TK) / TK;
+            float acc = 0;
+            for (std::size_t i = 0; i < tiles; i++) {
+                // hint: 转置的操作数改为按列分配给 work-item，使相邻 work-item 仍然读取相邻的全局地址
+                for (auto e = local_id; e < WM * TK; e += WM * WN) {
+                    auto r = OpA == my::op::n ? e / TK : e % WM, k = OpA == my::op::n ? e % TK : e / WM;
+                    auto row = block_row + r, col = i * TK + k;
+                    a_t[r][k] = row < m && col < n ? 
+                        static_cast<float>(OpA == my::op::n ? a[row][col] : a[col][row]) : 0.f;
+                }
+                for (auto e = local_id; e < TK * WN; e += WM * WN) {
+                    auto k = OpB == my::op::n ? e / WN : e % TK, s = OpB == my::op::n ? e % WN : e / TK;
+                    auto row = i * TK + k, col = block_col + s;
+                    b_t[k][s] = row < n && col < p ? 
+                        static_cast<float>(OpB == my::op::n ? b[row][col] : b[col][row]) : 0.f;
+                }
+                item.barrier(sycl::access::fence_space::local_space);
+                for (int j = 0; j < TK; j++) {
+                    acc += a_t[local_row][j] * b_t[j][local_col];
+                }
+                item.barrier(sycl::access::fence_space::local_space);
+            }
+            if (global_row < m && global_col < p) {
+                if constexpr (Epilogue::reads_c)
+                    c[global_row][global_col] = epilogue(acc, global_row, global_col, c[global_row][global_col]);
+                else c[global_row][global_col] = epilogue(acc, global_row, global_col, 0.f);
+            }
+        });   
+    });    
+
+    mm.wait();
+    auto start = mm.template get_profiling_info<sycl::info::event_profiling::command_start>();
+    auto end = mm.template get_profiling_info<sycl::info::event_profiling::command_end>();
+    return (end - start) * 1e-6;
+}
+
+// 自动调优的候选配置：work-group 形状 WM x WN 与 K 方向 tile 宽度 TK
+struct tile_config {
+    std::string name;
+    int wm, wn, tk;
+    double (*run)(sycl::queue &, sycl::buffer<float, 2> &, sycl::buffer<float, 2> &, sycl::buffer<float, 2> &);
+};
+
+template <int WM, int WN, int TK>
+tile_config make_tile_config() {
+    auto name = std::to_string(WM) + "x" + std::to_string(WN) + "x" + std::to_string(TK);
+    // hint: tiled_kernel 带有默认的 epilogue 参数，经由无捕获的 lambda 转换为四个参数的函数指针
+    return {name, WM, WN, TK, [](sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float, 2> &b_buf, 
+                                 sycl::buffer<float, 2> &c_buf) { 
+        return tiled_kernel<WM, WN, TK>(q, a_buf, b_buf, c_buf); 
+    }};
+}
+
+const std::vector<tile_config> tile_configs = {
+    make_tile_config<8, 8, 8>(), make_tile_config<8, 8, 32>(),
+    make_tile_config<16, 16, 16>(), make_tile_config<16, 16, 32>(),
+    make_tile_config<32, 8, 16>(), make_tile_config<8, 32, 16>(),
+    make_tile_config<32, 32, 32>(), make_tile_config<16, 64, 16>(),
+};
+
+// 为当前设备和问题规模挑选 tiled_kernel 配置：缓存命中时直接使用，否则逐个测量并把最快的写入缓存
+const tile_config &tuned_config(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float, 2> &b_buf, 
+            bool retune = false) {
+    auto device = q.get_device();
+    my::device_info info{device.get_info<sycl::info::device::name>(), device};
+    auto m = a_buf.get_range()[0], n = a_buf.get_range()[1], p = b_buf.get_range()[1];
+    auto key = "tiled_kernel/" + my::size_bucket({m, n, p});
+    my::tuning_cache cache;
+
+    auto cached = cache.find(info, key);
+    auto by_name = [&](const std::string &name) {
+        return std::find_if(tile_configs.begin(), tile_configs.end(), [&](auto &config) { return config.name == name; });
+    };
+    if (!retune && cached.has_value() && by_name(*cached) != tile_configs.end()) {
+        std::cout << "Tuned tile (cached): " << *cached << "\n\n";
+        return *by_name(*cached);
+    }
+
+    auto max_group = device.get_info<sycl::info::device::max_work_group_size>();
+    auto local_mem = device.get_info<sycl::info::device::local_mem_size>();
+    const tile_config *best = nullptr;
+    double best_duration = std::numeric_limits<double>::max();
+    sycl::buffer<float, 2> c_buf(sycl::range(m, p));
+    std::cout << "Tuning tiled kernel for " << info.name << " (" << key << ")...\n";
+    for (auto &config : tile_configs) {
+        if (std::size_t(config.wm * config.wn) > max_group ||
+            sizeof(float) * config.tk * (config.wm + config.wn) > local_mem)
+            continue;
+        config.run(q, a_buf, b_buf, c_buf);     // 预热，排除 JIT 编译的耗时
+        auto duration = config.run(q, a_buf, b_buf, c_buf);
+        std::cout << "  " << config.name << ": " << duration << " ms\n";
+        if (duration < best_duration)
+            best_duration = duration, best = &config;
+    }
+    if (best == nullptr)
+        throw std::runtime_error("No tile configuration fits the device");
+    cache.store(info, key, best->name);
+    std::cout << "Tuned tile: " << best->name << "\n\n";
+    return *best;
+}
+
+using bfloat16 = sycl::ext::oneapi::bfloat16;
+
+// 输入存储类型的机器精度，用来确定低精度结果与 float 参考结果比较时的容差
+template <typename T>
+constexpr float storage_epsilon = std::numeric_limits<T>::epsilon();
+template <>
+constexpr float storage_epsilon<sycl::half> = 0x1p-10f;
+template <>
+constexpr float storage_epsilon<bfloat16> = 0x1p-7f;
+
+// 在 device 上把 float 矩阵转换为 T 存储的新 buffer
+template <typename T>
+sycl::buffer<T, 2> convert_buffer(sycl::queue &q, sycl::buffer<float, 2> &src_buf) {
+    sycl::buffer<T, 2> dst_buf(src_buf.get_range());
+    q.submit([&](sycl::handler &h) {
+        sycl::accessor src(src_buf, h, sycl::read_only);
+        sycl::accessor dst(dst_buf, h, sycl::write_only, sycl::no_init);
+        h.parallel_for(src.get_range(), [=](sycl::id<2> index) { dst[index] = static_cast<T>(src[index]); });
+    });
+    return dst_buf;
+}
+
+// 混合精度：A、B 在 device 上转换为 T 存储，以 float 累加并输出 float 的 C
+// 输入的显存占用与读取带宽均为 float 版本的 sizeof(T) / sizeof(float)
+// hint: 直接读取已上传的 a_buf、b_buf，不在同一块 host 存储上再构造 buffer；返回值不含转换的耗时
+template <typename T>
+double mixed_precision(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float, 2> &b_buf, 
+                       sycl::buffer<float, 2> &c_buf) {
+    auto a_low = convert_buffer<T>(q, a_buf);
+    auto b_low = convert_buffer<T>(q, b_buf);
+    std::cout << "Input footprint: " << (a_low.byte_size() + b_low.byte_size()) / 1024 << " KiB ("
+              << (a_buf.byte_size() + b_buf.byte_size()) / 1024 << " KiB as float)\n";
+    return tiled_kernel<matrix_unit_size, matrix_unit_size, matrix_unit_size, T>(q, a_low, b_low, c_buf);
+}
+
+// 低精度输入的误差容差：每个输入的舍入误差约为 eps/2，K 项随机累积后按 sqrt(K) 增长，留 4 倍余量
+template <typename T, typename MatA, typename MatB>
+float mixed_tolerance(const MatA &a_host, const MatB &b_host) {
+    auto abs_max = [](auto &matrix) {
+        return std::accumulate(matrix.begin(), matrix.end(), 0.f, [](float x, float v) { return std::max(x, std::abs(v)); });
+    };
+    return 4 * storage_epsilon<T> * std::sqrt(float(a_host.cols())) * abs_max(a_host) * abs_max(b_host);
+}
+
+// 带转置标记的 tiled GEMM：c = op(a) * op(b)；a_buf、b_buf 是未转置的存储，转置发生在 tile 读入时
+template <my::op OpA, my::op OpB>
+double transposed_gemm(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float, 2> &b_buf, 
+                       sycl::buffer<float, 2> &c_buf) {
+    return tiled_kernel<matrix_unit_size, matrix_unit_size, matrix_unit_size, float, OpA, OpB>(q, a_buf, b_buf, c_buf);
+}
+
+// 融合尾处理的 tiled GEMM：c = epilogue(a * b)；reads_c 为 true 时 C 的初值取自 c0
+// epilogue.bias 指向 host 内存，在这里复制到 device 内存后替换为 device 指针；返回值不含这些复制的耗时
+template <typename Epilogue, typename Mat>
+double fused_gemm(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float, 2> &b_buf, 
+                  sycl::buffer<float, 2> &c_buf, const Mat &c0, Epilogue epilogue) {
+    std::size_t m = c_buf.get_range()[0], p = c_buf.get_range()[1];
+    float *bias = nullptr;
+    if constexpr (Epilogue::bias_type != bias_kind::none) {
+        auto count = Epilogue::bias_type == bias_kind::row ? m : p;
+        bias = sycl::malloc_device<float>(count, q);
+        q.memcpy(bias, epilogue.bias, sizeof(float) * count).wait();
+        epilogue.bias = bias;
+    }
+    if constexpr (Epilogue::reads_c) {
+        q.submit([&](sycl::handler &h) {
+            sycl::accessor c(c_buf, h, sycl::write_only, sycl::no_init);
+            h.copy(c0.begin(), c);
+        }).wait();
+    }
+    auto duration = tiled_kernel<matrix_unit_size, matrix_unit_size, matrix_unit_size, float, my::op::n, my::op::n>(
+        q, a_buf, b_buf, c_buf, epilogue);
+    if (bias != nullptr)
+        sycl::free(bias, q);
+    return duration;
+}
+
+// 在 host 上对乘积 product = a * b 应用同样的尾处理，作为 fused_gemm 的参考结果
+template <typename Mat, typename Epilogue>
+Mat apply_epilogue(const Mat &product, const Mat &c0, const Epilogue &epilogue) {
+    Mat result(product);
+    for (int i = 0; i < result.rows(); i++)
+        for (int j = 0; j < result.cols(); j++)
+            result[i][j] = epilogue(product[i][j], i, j, c0[i][j]);
+    return result;
+}
+
+// 融合尾处理的示例 c = relu(alpha * a * b + beta * c0 + 列偏置)
+// 偏置取 [-alpha * n / 2, 0) 内的随机数，a * b 的元素约为 n / 4，因此大约一半的元素被 ReLU 截断
+using example_epilogue = gemm_epilogue<true, bias_kind::col, activation::relu>;
+
+example_epilogue make_example_epilogue(int n, std::vector<float> &bias) {
+    example_epilogue epilogue{0.5f, 2.f};
+    my::rand<float> rand(-epilogue.alpha * n / 2, 0);
+    std::generate(bias.begin(), bias.end(), std::ref(rand));
+    epilogue.bias = bias.data();
+    return epilogue;
+}
+
+// 以 run（驱动中的 run lambda）运行一个融合尾处理的变体，并以 apply_epilogue 的结果作为参考
+// bias 非空时由这里持有偏置，kernel 与参考结果都使用它；为空时沿用 epilogue.bias
+// hint: 尾处理中的乘加可能被编译为 FMA，与 host 参考结果相差几个 ulp
+template <typename Epilogue, typename Run, typename Mat>
+void run_fused(Run &run, const std::string &label, sycl::queue &q, sycl::buffer<float, 2> &a_buf, 
+               sycl::buffer<float, 2> &b_buf, const Mat &c0, Epilogue epilogue, std::vector<float> bias = {}) {
+    const float tolerance = std::max(1e-4f, 4 * std::numeric_limits<float>::epsilon() * a_buf.get_range()[1]);
+    auto with_bias = [](Epilogue epilogue, const std::vector<float> &bias) {
+        if (!bias.empty()) epilogue.bias = bias.data();
+        return epilogue;
+    };
+    run("fused", label, [&](auto &c_buf) {
+        return fused_gemm(q, a_buf, b_buf, c_buf, c0, with_bias(epilogue, bias));
+    }, tolerance, [&c0, epilogue, bias, with_bias](const Mat &product) {
+        return apply_epilogue(product, c0, with_bias(epilogue, bias));
+    });
+}
+
+// 融合尾处理的全部变体，每个都是单独实例化的 kernel：示例（读取 C、列偏置、ReLU）之外，
+// 行偏置 + GELU 走不读取 C（beta = 0，C 只写不读）的路径，clamp 的上下界都会截断一部分元素
+template <typename Run, typename Mat>
+void run_fused_variants(Run &run, sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float, 2> &b_buf, 
+                        const Mat &c0, const example_epilogue &epilogue) {
+    const int m = a_buf.get_range()[0], n = a_buf.get_range()[1];
+    run_fused(run, "Fused relu(alpha AB + beta C + bias)", q, a_buf, b_buf, c0, epilogue);
+
+    // hint: 行偏置的取值与示例相同，结果大致对称地分布在 0 的两侧，GELU 的负半轴也被覆盖
+    gemm_epilogue<false, bias_kind::row, activation::gelu> gelu{0.5f};
+    std::vector<float> row_bias(m);
+    my::rand<float> rand(-gelu.alpha * n / 2, 0);
+    std::generate(row_bias.begin(), row_bias.end(), std::ref(rand));
+    run_fused(run, "Fused gelu(alpha AB + row bias)", q, a_buf, b_buf, c0, gelu, std::move(row_bias));
+
+    // hint: alpha = 4 / n 使 alpha AB 约为 1，加上 beta C 后分布在 [1, 9) 内，超出 [2, 6] 的部分被截断
+    gemm_epilogue<true, bias_kind::none, activation::clamp> clamp{4.f / n, 8.f};
+    clamp.clamp_min = 2.f;
+    run_fused(run, "Fused clamp(alpha AB + beta C, 2, 6)", q, a_buf, b_buf, c0, clamp);
+}
+
+// 批量 GEMM 中第 i 个乘积的操作数，均为行主序连续存储
+struct batch_operands {
+    const float *a, *b;
+    float *c;
+};
+
+// 批量 GEMM 的公共实现：一次 nd_range 提交计算全部 batch 个 c[m][p] = a[m][n] * b[n][p]
+// 第 0 维为 batch，每个 work-group 计算其中一个乘积的一个 16x16 分块；operands(i) 给出第 i 个乘积的指针
+template <typename Operands>
+sycl::event batched_tiled(sycl::queue &q, std::size_t m, std::size_t n, std::size_t p, std::size_t batch, 
+                          Operands operands) {
+    sycl::range<3> local_size(1, matrix_unit_size, matrix_unit_size);
+    sycl::range<3> global_size(batch, round_up(m), round_up(p));
+    return q.submit([&](sycl::handler &h) {
+        sycl::local_accessor<float, 2> a_t(sycl::range<2>(matrix_unit_size, matrix_unit_size), h);
+        sycl::local_accessor<float, 2> b_t(sycl::range<2>(matrix_unit_size, matrix_unit_size), h);
+
+        h.parallel_for(sycl::nd_range<3>(global_size, local_size), [=](sycl::nd_item<3> item) {
+            auto [a, b, c] = operands(item.get_global_id(0));
+            auto local_row = item.get_local_id(1), local_col = item.get_local_id(2);
+            auto global_row = item.get_group(1) * matrix_unit_size + local_row;
+            auto global_col = item.get_group(2) * matrix_unit_size + local_col;
+            auto tiles = round_up(n) / matrix_unit_size;
+            float acc = 0;
+            for (std::size_t i = 0; i < tiles; i++) {
+                auto tile_col = i * matrix_unit_size + local_col;
+                auto tile_row = i * matrix_unit_size + local_row;
+                a_t[local_row][local_col] = global_row < m && tile_col < n ? a[global_row * n + tile_col] : 0.f;
+                b_t[local_row][local_col] = tile_row < n && global_col < p ? b[tile_row * p + global_col] : 0.f;
+                item.barrier(sycl::access::fence_space::local_space);
+                for (int j = 0; j < matrix_unit_size; j++) {
+                    acc += a_t[local_row][j] * b_t[j][local_col];
+                }
+                item.barrier(sycl::access::fence_space::local_space);
+            }
+            if (global_row < m && global_col < p)
+                c[global_row * p + global_col] = acc;
+        });
+    });
+}
+
+// 跨步批量 GEMM：第 i 个乘积的操作数位于 a + i * stride_a、b + i * stride_b、c + i * stride_c（USM 指针）
+sycl::event gemm_batched_strided(sycl::queue &q, std::size_t m, std::size_t n, std::size_t p, std::size_t batch,
+                                 const float *a, std::size_t stride_a, const float *b, std::size_t stride_b, 
+                                 float *c, std::size_t stride_c) {
+    return batched_tiled(q, m, n, p, batch, [=](std::size_t i) {
+        return batch_operands{a + i * stride_a, b + i * stride_b, c + i * stride_c};
+    });
+}
+
+// 指针数组批量 GEMM：a_array、b_array、c_array 是存放在 device 可访问内存中的 batch 个 USM 指针
+sycl::event gemm_batched(sycl::queue &q, std::size_t m, std::size_t n, std::size_t p, std::size_t batch,
+                         const float *const *a_array, const float *const *b_array, float *const *c_array) {
+    return batched_tiled(q, m, n, p, batch, [=](std::size_t i) {
+        return batch_operands{a_array[i], b_array[i], c_array[i]};
+    });
+}
+
+// 等待 kernel 完成并返回其耗时（ms）
+double event_duration(sycl::event event) {
+    event.wait();
+    auto start = event.get_profiling_info<sycl::info::event_profiling::command_start>();
+    auto end = event.get_profiling_info<sycl::info::event_profiling::command_end>();
+    return (end - start) * 1e-6;
+}
+
+// device 内存（USM）中行跨度为 ld 的 rows x cols 子矩阵
+struct device_view {
+    float *data;
+    std::size_t rows, cols, ld;
+
+    // 等分为 2x2 块后的第 (i, j) 块；调用方保证行数、列数均为偶数
+    device_view quadrant(int i, int j) const {
+        auto r = rows / 2, c = cols / 2;
+        return {data + i * r * ld + j * c, r, c, ld};
+    }
+};
+
+// 逐元素 z = x + sign * y，三者形状相同；z 可以与 x 或 y 是同一块内存
+double matrix_add(sycl::queue &q, device_view x, device_view y, device_view z, float sign = 1.f) {
+    return event_duration(q.parallel_for(sycl::range<2>(z.rows, z.cols), [=](sycl::id<2> index) {
+        auto i = index[0], j = index[1];
+        z.data[i * z.ld + j] = x.data[i * x.ld + j] + sign * y.data[i * y.ld + j];
+    }));
+}
+
+// 与 kernel2 相同的 16x16 tiled 乘法，操作数为带行跨度的子矩阵；只提交不等待，depends 中的事件完成后才开始
+// accumulate 为 true 时计算 c += a * b，否则 c = a * b
+sycl::event submit_tiled_view(sycl::queue &q, device_view a, device_view b, device_view c, bool accumulate = false,
+                              const std::vector<sycl::event> &depends = {}) {
+    std::size_t m = c.rows, n = a.cols, p = c.cols;
+    sycl::range<2> local_size(matrix_unit_size, matrix_unit_size);
+    sycl::range<2> global_size(round_up(m), round_up(p));
+    return q.submit([&](sycl::handler &h) {
+        h.depends_on(depends);
+        sycl::local_accessor<float, 2> a_t(sycl::range<2>(matrix_unit_size, matrix_unit_size), h);
+        sycl::local_accessor<float, 2> b_t(sycl::range<2>(matrix_unit_size, matrix_unit_size), h);
+
+        h.parallel_for(sycl::nd_range<2>(global_size, local_size), [=](sycl::nd_item<2> item) {
+            auto local_row = item.get_local_id(0), local_col = item.get_local_id(1);
+            auto global_row = item.get_group(0) * matrix_unit_size + local_row;
+            auto global_col = item.get_group(1) * matrix_unit_size + local_col;
+            auto tiles = round_up(n) / matrix_unit_size;
+            float acc = 0;
+            for (std::size_t i = 0; i < tiles; i++) {
+                auto tile_col = i * matrix_unit_size + local_col;
+                auto tile_row = i * matrix_unit_size + local_row;
+                a_t[local_row][local_col] = global_row < m && tile_col < n ? a.data[global_row * a.ld + tile_col] : 0.f;
+                b_t[local_row][local_col] = tile_row < n && global_col < p ? b.data[tile_row * b.ld + global_col] : 0.f;
+                item.barrier(sycl::access::fence_space::local_space);
+                for (int j = 0; j < matrix_unit_size; j++) {
+                    acc += a_t[local_row][j] * b_t[j][local_col];
+                }
+                item.barrier(sycl::access::fence_space::local_space);
+            }
+            if (global_row < m && global_col < p)
+                c.data[global_row * c.ld + global_col] = accumulate ? c.data[global_row * c.ld + global_col] + acc : acc;
+        });
+    });
+}
+
+// Strassen–Winograd 的基础情形
+double tiled_view(sycl::queue &q, device_view a, device_view b, device_view c) {
+    return event_duration(submit_tiled_view(q, a, b, c));
+}
+
+// Strassen–Winograd 递归 c = a * b：每层 7 次半尺寸乘法与 15 次加减，子问题的边长均不超过 cutoff 时调用 tiled_view
+// hint: 乘积的计算顺序使得每层只需 X、Y 两个 m/2 x p/2 的临时矩阵，其余中间结果直接写在 C 的四个块中
+double strassen_winograd(sycl::queue &q, device_view a, device_view b, device_view c, std::size_t cutoff) {
+    if (std::max({c.rows, a.cols, c.cols}) <= cutoff || c.rows % 2 || a.cols % 2 || c.cols % 2)
+        return tiled_view(q, a, b, c);
+    const std::size_t m = c.rows / 2, n = a.cols / 2, p = c.cols / 2;
+    auto workspace = sycl::malloc_device<float>(4 * m * n + 4 * n * p + 2 * m * p, q);
+    auto next = workspace;
+    auto temporary = [&](std::size_t rows, std::size_t cols) {
+        device_view view{next, rows, cols, cols};
+        next += rows * cols;
+        return view;
+    };
+    auto s1 = temporary(m, n), s2 = temporary(m, n), s3 = temporary(m, n), s4 = temporary(m, n);
+    auto t1 = temporary(n, p), t2 = temporary(n, p), t3 = temporary(n, p), t4 = temporary(n, p);
+    auto x = temporary(m, p), y = temporary(m, p);
+    auto a11 = a.quadrant(0, 0), a12 = a.quadrant(0, 1), a21 = a.quadrant(1, 0), a22 = a.quadrant(1, 1);
+    auto b11 = b.quadrant(0, 0), b12 = b.quadrant(0, 1), b21 = b.quadrant(1, 0), b22 = b.quadrant(1, 1);
+    auto c11 = c.quadrant(0, 0), c12 = c.quadrant(0, 1), c21 = c.quadrant(1, 0), c22 = c.quadrant(1, 1);
+    auto multiply = [&](device_view lhs, device_view rhs, device_view out) {
+        return strassen_winograd(q, lhs, rhs, out, cutoff);
+    };
+
+    double duration = 0;
+    duration += matrix_add(q, a21, a22, s1);            // S1 = A21 + A22
+    duration += matrix_add(q, s1, a11, s2, -1);         // S2 = S1 - A11
+    duration += matrix_add(q, a11, a21, s3, -1);        // S3 = A11 - A21
+    duration += matrix_add(q, a12, s2, s4, -1);         // S4 = A12 - S2
+    duration += matrix_add(q, b12, b11, t1, -1);        // T1 = B12 - B11
+    duration += matrix_add(q, b22, t1, t2, -1);         // T2 = B22 - T1
+    duration += matrix_add(q, b22, b12, t3, -1);        // T3 = B22 - B12
+    duration += matrix_add(q, t2, b21, t4, -1);         // T4 = T2 - B21
+    duration += multiply(a11, b11, x);                  // X = P1 = A11 * B11
+    duration += multiply(a12, b21, c11);                // P2 = A12 * B21
+    duration += matrix_add(q, c11, x, c11);             // C11 = P1 + P2
+    duration += multiply(s2, t2, y);                    // P6 = S2 * T2
+    duration += matrix_add(q, x, y, x);                 // X = U2 = P1 + P6
+    duration += multiply(s3, t3, y);                    // P7 = S3 * T3
+    duration += matrix_add(q, x, y, c21);               // C21 = U3 = U2 + P7
+    duration += multiply(s1, t1, y);                    // P5 = S1 * T1
+    duration += matrix_add(q, x, y, x);                 // X = U4 = U2 + P5
+    duration += matrix_add(q, c21, y, c22);             // C22 = U3 + P5
+    duration += multiply(s4, b22, y);                   // P3 = S4 * B22
+    duration += matrix_add(q, x, y, c12);               // C12 = U4 + P3
+    duration += multiply(a22, t4, y);                   // P4 = A22 * T4
+    duration += matrix_add(q, c21, y, c21, -1);         // C21 = U3 - P4
+    sycl::free(workspace, q);
+    return duration;
+}
+
+// 递归层数：每层把三个维度减半，直到最大边长不超过 cutoff
+std::size_t strassen_levels(std::size_t m, std::size_t n, std::size_t p, std::size_t cutoff) {
+    std::size_t levels = 0;
+    while (std::max({m, n, p}) > cutoff << levels) levels++;
+    return levels;
+}
+
+// 把 buf 复制到 rows x cols（不小于原矩阵）的 device 矩阵中，多出的部分填 0
+void upload_padded(sycl::queue &q, sycl::buffer<float, 2> &buf, float *device, std::size_t rows, std::size_t cols) {
+    q.submit([&](sycl::handler &h) {
+        sycl::accessor src(buf, h, sycl::read_only);
+        auto src_rows = src.get_range()[0], src_cols = src.get_range()[1];
+        h.parallel_for(sycl::range<2>(rows, cols), [=](sycl::id<2> index) {
+            auto i = index[0], j = index[1];
+            device[i * cols + j] = i < src_rows && j < src_cols ? src[i][j] : 0.f;
+        });
+    }).wait();
+}
+
+// Strassen–Winograd 模式：A、B 复制到按 2^levels 补 0 对齐的 device 矩阵中递归计算，再把有效部分写回 c_buf
+// 返回递归中全部 kernel 的耗时之和（ms），不含补齐与写回
+double strassen(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float, 2> &b_buf, 
+                sycl::buffer<float, 2> &c_buf, std::size_t cutoff = strassen_cutoff, bool verbose = true) {
+    const std::size_t m = a_buf.get_range()[0], n = a_buf.get_range()[1], p = b_buf.get_range()[1];
+    const auto levels = strassen_levels(m, n, p, cutoff);
+    const auto unit = std::size_t(1) << levels;
+    const auto m_pad = round_up(m, unit), n_pad = round_up(n, unit), p_pad = round_up(p, unit);
+    if (verbose)
+        std::cout << "Strassen-Winograd: " << levels << " levels, padded to " << m_pad << "x" << n_pad << "x" << p_pad 
+                  << ", base case " << m_pad / unit << "x" << n_pad / unit << "x" << p_pad / unit << "\n";
+
+    auto a = sycl::malloc_device<float>(m_pad * n_pad, q);
+    auto b = sycl::malloc_device<float>(n_pad * p_pad, q);
+    auto c = sycl::malloc_device<float>(m_pad * p_pad, q);
+    upload_padded(q, a_buf, a, m_pad, n_pad);
+    upload_padded(q, b_buf, b, n_pad, p_pad);
+    auto duration = strassen_winograd(q, {a, m_pad, n_pad, n_pad}, {b, n_pad, p_pad, p_pad}, 
+                                      {c, m_pad, p_pad, p_pad}, cutoff);
+    q.submit([&](sycl::handler &h) {
+        sycl::accessor dst(c_buf, h, sycl::write_only, sycl::no_init);
+        h.parallel_for(c_buf.get_range(), [=](sycl::id<2> index) {
+            dst[index] = c[index[0] * p_pad + index[1]];
+        });
+    }).wait();
+    sycl::free(a, q), sycl::free(b, q), sycl::free(c, q);
+    return duration;
+}
+
+// Strassen–Winograd 的误差容差：经典算法的误差约为 eps * K * max|a| * max|b|，
+// 每一层递归中 S、T 的加减使操作数的量级翻倍，误差界随层数按 4^levels 放大
+template <typename MatA, typename MatB>
+float strassen_tolerance(const MatA &a_host, const MatB &b_host, std::size_t cutoff = strassen_cutoff) {
+    auto abs_max = [](auto &matrix) {
+        return std::accumulate(matrix.begin(), matrix.end(), 0.f, [](float x, float v) { return std::max(x, std::abs(v)); });
+    };
+    auto levels = strassen_levels(a_host.rows(), a_host.cols(), b_host.cols(), cutoff);
+    return std::max(1e-4f, std::numeric_limits<float>::epsilon() * a_host.cols() * float(1 << 2 * levels) 
+                           * abs_max(a_host) * abs_max(b_host));
+}
+
+// 外存 GEMM c[m][p] = a[m][n] * b[n][p]：a、b、c 为映射到内存的行主序文件，不需要整体放入内存或显存
+// C 按 block x block 分块，每个 C 分块沿 K 方向依次流过 block x block 的 A、B 分块并在 device 上累加；
+// device 上固定只有两组 A、B 分块与一个 C 分块
+// hint: 两组分块轮流使用：host 从文件中打包并上传下一组分块时，device 正在计算上一组，文件读取、传输与计算重叠
+// 返回 kernel 耗时之和（ms）；block 必须大于 0
+double out_of_core_gemm(sycl::queue &q, const float *a, const float *b, float *c, 
+                        std::size_t m, std::size_t n, std::size_t p, std::size_t block) {
+    if (block == 0)
+        throw std::runtime_error("Out-of-core block size must be positive");
+    if (n == 0) {
+        std::fill_n(c, m * p, 0.f);     // K 方向为空时乘积为 0，C 分块上没有 kernel 可以等待
+        return 0;
+    }
+    const std::size_t panel = block * block;
+    float *a_stage[2], *b_stage[2], *a_dev[2], *b_dev[2];
+    for (int s = 0; s < 2; s++) {
+        a_stage[s] = sycl::malloc_host<float>(panel, q), b_stage[s] = sycl::malloc_host<float>(panel, q);
+        a_dev[s] = sycl::malloc_device<float>(panel, q), b_dev[s] = sycl::malloc_device<float>(panel, q);
+    }
+    auto c_stage = sycl::malloc_host<float>(panel, q);
+    auto c_dev = sycl::malloc_device<float>(panel, q);
+
+    // 每个槽位上最近一次提交、尚未计时的 kernel；它完成后槽位中的数据才能被覆盖
+    std::optional<sycl::event> pending[2];
+    double kernel_duration = 0;
+    auto retire = [&](int slot) {
+        if (pending[slot].has_value())
+            kernel_duration += event_duration(*pending[slot]);
+        pending[slot].reset();
+    };
+
+    int slot = 0;
+    for (std::size_t i0 = 0; i0 < m; i0 += block) {
+        for (std::size_t j0 = 0; j0 < p; j0 += block) {
+            const auto mb = std::min(block, m - i0), pb = std::min(block, p - j0);
+            std::optional<sycl::event> last;   // 同一个 C 分块上的累加按顺序进行
+            for (std::size_t k0 = 0; k0 < n; k0 += block, slot = 1 - slot) {
+                const auto kb = std::min(block, n - k0);
+                retire(slot);
+                for (std::size_t r = 0; r < mb; r++)
+                    std::copy_n(a + (i0 + r) * n + k0, kb, a_stage[slot] + r * kb);
+                for (std::size_t r = 0; r < kb; r++)
+                    std::copy_n(b + (k0 + r) * p + j0, pb, b_stage[slot] + r * pb);
+                std::vector<sycl::event> depends = {q.memcpy(a_dev[slot], a_stage[slot], sizeof(float) * mb * kb), 
+                                                    q.memcpy(b_dev[slot], b_stage[slot], sizeof(float) * kb * pb)};
+                if (last.has_value())
+                    depends.push_back(*last);
+                last = submit_tiled_view(q, {a_dev[slot], mb, kb, kb}, {b_dev[slot], kb, pb, pb}, {c_dev, mb, pb, pb},
+                                         k0 > 0, depends);
+                pending[slot] = last;
+            }
+            q.submit([&](sycl::handler &h) {
+                h.depends_on(*last);
+                h.memcpy(c_stage, c_dev, sizeof(float) * mb * pb);
+            }).wait();
+            for (std::size_t r = 0; r < mb; r++)
+                std::copy_n(c_stage + r * pb, pb, c + (i0 + r) * p + j0);
+        }
+    }
+    retire(0), retire(1);
+
+    for (int s = 0; s < 2; s++) {
+        sycl::free(a_stage[s], q), sycl::free(b_stage[s], q);
+        sycl::free(a_dev[s], q), sycl::free(b_dev[s], q);
+    }
+    sycl::free(c_stage, q), sycl::free(c_dev, q);
+    return kernel_duration;
+}
+
+// 稠密 GEMV y = a * x，作为 SpMV 的对照：每个 work-item 计算 y 的一个元素
+double gemv(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float> &x_buf, sycl::buffer<float> &y_buf) {
+    return event_duration(q.submit([&](sycl::handler &h) {
+        sycl::accessor a(a_buf, h, sycl::read_only);
+        sycl::accessor x(x_buf, h, sycl::read_only);
+        sycl::accessor y(y_buf, h, sycl::write_only, sycl::no_init);
+        int n = a.get_range()[1];
+        h.parallel_for(y.get_range(), [=](sycl::id<1> index) {
+            auto row = index[0];
+            float sum = 0;
+            for (int k = 0; k < n; k++)
+                sum += a[row][k] * x[k];
+            y[index] = sum;
+        });
+    }));
+}
+
+// CSR SpMV y = a * x：每个 work-item 计算一行，只读取该行的非零元
+double spmv_csr(sycl::queue &q, my::csr_buffers<float> &a, sycl::buffer<float> &x_buf, sycl::buffer<float> &y_buf) {
+    return event_duration(q.submit([&](sycl::handler &h) {
+        sycl::accessor row_ptr(a.row_ptr, h, sycl::read_only);
+        sycl::accessor col_idx(a.col_idx, h, sycl::read_only);
+        sycl::accessor values(a.values, h, sycl::read_only);
+        sycl::accessor x(x_buf, h, sycl::read_only);
+        sycl::accessor y(y_buf, h, sycl::write_only, sycl::no_init);
+        h.parallel_for(y.get_range(), [=](sycl::id<1> index) {
+            auto row = index[0];
+            float sum = 0;
+            for (int e = row_ptr[row]; e < row_ptr[row + 1]; e++)
+                sum += values[e] * x[col_idx[e]];
+            y[index] = sum;
+        });
+    }));
+}
+
+// Sliced ELL SpMV y = a * x：每个 work-item 计算一行，同一片中相邻行的非零元地址相邻，读取合并
+double spmv_sell(sycl::queue &q, my::sell_buffers<float> &a, int slice_height, sycl::buffer<float> &x_buf, 
+                 sycl::buffer<float> &y_buf) {
+    return event_duration(q.submit([&](sycl::handler &h) {
+        sycl::accessor slice_ptr(a.slice_ptr, h, sycl::read_only);
+        sycl::accessor slice_width(a.slice_width, h, sycl::read_only);
+        sycl::accessor col_idx(a.col_idx, h, sycl::read_only);
+        sycl::accessor values(a.values, h, sycl::read_only);
+        sycl::accessor x(x_buf, h, sycl::read_only);
+        sycl::accessor y(y_buf, h, sycl::write_only, sycl::no_init);
+        h.parallel_for(y.get_range(), [=](sycl::id<1> index) {
+            auto slice = index[0] / slice_height, offset = index[0] % slice_height;
+            float sum = 0;
+            for (int j = 0; j < slice_width[slice]; j++) {
+                auto e = slice_ptr[slice] + j * slice_height + offset;
+                sum += values[e] * x[col_idx[e]];
+            }
+            y[index] = sum;
+        });
+    }));
+}
+
+// CSR 稀疏矩阵乘稠密矩阵 c[m][p] = a * b[n][p]：每个 work-item 计算 C 的一个元素，
+// 同一行的 work-item 遍历 A 的同一行非零元，相邻 work-item 读取 B 同一行中相邻的元素
+double spmm_csr(sycl::queue &q, my::csr_buffers<float> &a, sycl::buffer<float, 2> &b_buf, 
+                sycl::buffer<float, 2> &c_buf) {
+    return event_duration(q.submit([&](sycl::handler &h) {
+        sycl::accessor row_ptr(a.row_ptr, h, sycl::read_only);
+        sycl::accessor col_idx(a.col_idx, h, sycl::read_only);
+        sycl::accessor values(a.values, h, sycl::read_only);
+        sycl::accessor b(b_buf, h, sycl::read_only);
+        sycl::accessor c(c_buf, h, sycl::write_only, sycl::no_init);
+        h.parallel_for(c.get_range(), [=](sycl::id<2> index) {
+            auto row = index[0], col = index[1];
+            float sum = 0;
+            for (int e = row_ptr[row]; e < row_ptr[row + 1]; e++)
+                sum += values[e] * b[col_idx[e]][col];
+            c[index] = sum;
+        });
+    }));
+}
+
+// 量化 GEMM：A 按行、B 按列量化（见 my::quantized_mat），K 方向每 4 个元素打包为一个 32 位字，每次取一个字做 4 路点积
+// K 循环中只以 int32 累加原始乘积 Σ ab，写回前展开零点：Σ (a - za)(b - zb) = Σ ab - zb Σa - za Σb + K za zb
+// c_int 为精确的整数结果，c 为反量化的结果 sa * sb * c_int；每个 work-item 计算一个 C 元素，K 方向每次读入 TW 个字
+// k 不能超过 my::quantized_max_k，否则 int32 累加会溢出
+template <typename TA, typename TB, int TW = 8>
+double quantized_kernel(sycl::queue &q, sycl::buffer<std::uint32_t, 2> &a_buf, my::quant_buffers &a_params,
+                        sycl::buffer<std::uint32_t, 2> &b_buf, my::quant_buffers &b_params, int k,
+                        sycl::buffer<std::int32_t, 2> &c_int_buf, sycl::buffer<float, 2> &c_buf) {
+    my::check_quantized_k(k);
+    std::size_t m = c_buf.get_range()[0], words = a_buf.get_range()[1], p = c_buf.get_range()[1];
+    sycl::range<2> local_size(matrix_unit_size, matrix_unit_size);
+    sycl::range<2> global_size(round_up(m), round_up(p));
+    return event_duration(q.submit([&](sycl::handler &h) {
+        sycl::accessor a(a_buf, h, sycl::read_only);
+        sycl::accessor b(b_buf, h, sycl::read_only);
+        sycl::accessor a_scale(a_params.scale, h, sycl::read_only);
+        sycl::accessor a_zero(a_params.zero_point, h, sycl::read_only);
+        sycl::accessor a_sums(a_params.sums, h, sycl::read_only);
+        sycl::accessor b_scale(b_params.scale, h, sycl::read_only);
+        sycl::accessor b_zero(b_params.zero_point, h, sycl::read_only);
+        sycl::accessor b_sums(b_params.sums, h, sycl::read_only);
+        sycl::accessor c_int(c_int_buf, h, sycl::write_only, sycl::no_init);
+        sycl::accessor c(c_buf, h, sycl::write_only, sycl::no_init);
+
+        sycl::local_accessor<std::uint32_t, 2> a_t(sycl::range<2>(matrix_unit_size, TW), h);
+        sycl::local_accessor<std::uint32_t, 2> b_t(sycl::range<2>(TW, matrix_unit_size), h);
+
+        h.parallel_for(sycl::nd_range<2>(global_size, local_size), [=](sycl::nd_item<2> item) {
+            auto local_row = item.get_local_id(0), local_col = item.get_local_id(1);
+            auto block_row = item.get_group(0) * matrix_unit_size, block_col = item.get_group(1) * matrix_unit_size;
+            auto global_row = block_row + local_row, global_col = block_col + local_col;
+            auto local_id = item.get_local_linear_id();
+            auto tiles = round_up(words, TW) / TW;
+            int acc = 0;
+            for (std::size_t i = 0; i < tiles; i++) {
+                // hint: 越界的字填 0，与打包时补齐的字节一样不影响 Σ ab
+                for (auto e = local_id; e < matrix_unit_size * TW; e += matrix_unit_size * matrix_unit_size) {
+                    auto row = block_row + e / TW, col = i * TW + e % TW;
+                    a_t[e / TW][e % TW] = row < m && col < words ? a[row][col] : 0u;
+                }
+                for (auto e = local_id; e < TW * matrix_unit_size; e += matrix_unit_size * matrix_unit_size) {
+                    auto row = i * TW + e / matrix_unit_size, col = block_col + e % matrix_unit_size;
+                    b_t[e / matrix_unit_size][e % matrix_unit_size] = row < words && col < p ? b[row][col] : 0u;
+                }
+                item.barrier(sycl::access::fence_space::local_space);
+                for (int w = 0; w < TW; w++)
+                    acc += my::dot4<TA, TB>(a_t[local_row][w], b_t[w][local_col]);
+                item.barrier(sycl::access::fence_space::local_space);
+            }
+            if (global_row < m && global_col < p) {
+                int za = a_zero[global_row], zb = b_zero[global_col];
+                int result = acc - zb * a_sums[global_row] - za * b_sums[global_col] + k * za * zb;
+                c_int[global_row][global_col] = result;
+                c[global_row][global_col] = a_scale[global_row] * b_scale[global_col] * float(result);
+            }
+        });
+    }));
+}
+
+// 复制 b = a，作为转置 kernel 的带宽上限
+double copy_kernel(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float, 2> &b_buf) {
+    return event_duration(q.submit([&](sycl::handler &h) {
+        sycl::accessor a(a_buf, h, sycl::read_only);
+        sycl::accessor b(b_buf, h, sycl::write_only, sycl::no_init);
+        h.parallel_for(a.get_range(), [=](sycl::id<2> index) { b[index] = a[index]; });
+    }));
+}
+
+// 朴素转置 b = a^T：相邻 work-item 读取相邻元素，但写入地址相隔一整行，写入不合并
+double naive_transpose(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float, 2> &b_buf) {
+    return event_duration(q.submit([&](sycl::handler &h) {
+        sycl::accessor a(a_buf, h, sycl::read_only);
+        sycl::accessor b(b_buf, h, sycl::write_only, sycl::no_init);
+        h.parallel_for(a.get_range(), [=](sycl::id<2> index) { b[index[1]][index[0]] = a[index]; });
+    }));
+}
+
+// 分块转置 b = a^T：work-group 按行读入 A 的一个 tile，在 local memory 中转置后按行写出，读写都是合并的
+// hint: tile 每行补齐 1 个元素，按列读取 tile 时相邻 work-item 的地址相隔 17 个元素，落在不同的 bank 上
+double tiled_transpose(sycl::queue &q, sycl::buffer<float, 2> &a_buf, sycl::buffer<float, 2> &b_buf) {
+    std::size_t m = a_buf.get_range()[0], n = a_buf.get_range()[1];
+    sycl::range<2> local_size(matrix_unit_size, matrix_unit_size);
+    sycl::range<2> global_size(round_up(m), round_up(n));
+    return event_duration(q.submit([&](sycl::handler &h) {
+        sycl::accessor a(a_buf, h, sycl::read_only);
+        sycl::accessor b(b_buf, h, sycl::write_only, sycl::no_init);
+        sycl::local_accessor<float, 2> tile(sycl::range<2>(matrix_unit_size, matrix_unit_size + 1), h);
+        h.parallel_for(sycl::nd_range<2>(global_size, local_size), [=](sycl::nd_item<2> item) {
+            auto local_row = item.get_local_id(0), local_col = item.get_local_id(1);
+            auto first_row = item.get_group(0) * matrix_unit_size, first_col = item.get_group(1) * matrix_unit_size;
+            if (first_row + local_row < m && first_col + local_col < n)
+                tile[local_row][local_col] = a[first_row + local_row][first_col + local_col];
+            item.barrier(sycl::access::fence_space::local_space);
+            // hint: 输出 tile 的第 local_row 行是输入 tile 的第 local_row 列
+            if (first_col + local_row < n && first_row + local_col < m)
+                b[first_col + local_row][first_row + local_col] = tile[local_col][local_row];
+        });
+    }));
+}
+
+// 由 host 计时区间计算达到的 GFLOP/s
+template <typename TimePoint>
+double host_gflops(TimePoint start, TimePoint end, double m = M, double n = N, double p = P) {
+    return gflops(std::chrono::duration<double, std::milli>(end - start).count(), m, n, p);
+}
+
+// 以 1, 2, 4, ... 个线程分别运行 host 分块 GEMM，输出吞吐量与相对单线程的加速比
+template <typename MatA, typename MatB>
+void report_host_scaling(const MatA &a, const MatB &b) {
+    const int m = a.rows(), n = a.cols(), p = b.cols(), max_threads = my::host_threads();
+    my::dyn_mat<float> c(m, p);
+    double single = 0;
+    std::cout << "Host scaling:\n";
+    for (int threads = 1; ; threads = std::min(threads * 2, max_threads)) {
+        auto start = std::chrono::high_resolution_clock::now();
+        my::gemm(m, n, p, a.begin(), n, b.begin(), p, c.data(), p, threads);
+        auto end = std::chrono::high_resolution_clock::now();
+        auto rate = host_gflops(start, end, m, n, p);
+        if (threads == 1) single = rate;
+        std::cout << "  " << std::setw(3) << threads << " threads: " << rate << " GFLOP/s, speedup "
+                  << rate / single << ", efficiency " << rate / single / threads * 100 << "%\n";
+        if (threads == max_threads) break;
+    }
+    std::cout << std::endl;
+}
+
+// 把 host 矩阵上传为 device buffer，upload_duration 累加显式传输的耗时（ms）
+// 与 host 共享内存的设备（CPU）直接在矩阵存储上构造 buffer，零拷贝；其余设备用一次 handler::copy 整块传输
+template <typename Mat>
+sycl::buffer<float, 2> upload(sycl::queue &q, Mat &host, double &upload_duration) {
+    if (q.get_device().is_cpu())
+        return host.buffer();
+    sycl::buffer<float, 2> buf(sycl::range(host.rows(), host.cols()));
+    auto copy = q.submit([&](sycl::handler &h) {
+        sycl::accessor device(buf, h, sycl::write_only, sycl::no_init);
+        h.copy(host.data(), device);
+    });
+    copy.wait();
+    auto start = copy.template get_profiling_info<sycl::info::event_profiling::command_start>();
+    auto end = copy.template get_profiling_info<sycl::info::event_profiling::command_end>();
+    upload_duration += (end - start) * 1e-6;
+    return buf;
+}
+
+// 上传 A、B 并输出上传耗时，与之后各 kernel 的耗时分开统计
+template <typename MatA, typename MatB>
+auto upload_operands(sycl::queue &q, MatA &a_host, MatB &b_host) {
+    double upload_duration = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    auto a_buf = upload(q, a_host, upload_duration);
+    auto b_buf = upload(q, b_host, upload_duration);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration<double, std::milli>(end - start).count();
+    std::cout << "Upload duration: " << duration << " ms, " << upload_duration << " ms in copies"
+              << (q.get_device().is_cpu() ? " (zero-copy)" : " (bulk copy)") << "\n\n";
+    return std::make_pair(a_buf, b_buf);
+}
+
+// 运行一个 device kernel，输出总耗时、kernel 耗时与吞吐量
+template <typename F>
+void run_on_device(const std::string &label, F &&run, double m = M, double n = N, double p = P) {
+    auto suffix = label.empty() ? std::string() : " (" + label + ")";
+    std::cout << "Running on device" << suffix << "...\n";
+    auto start = std::chrono::high_resolution_clock::now();
+    auto kernel_duration = run();
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "Device duration" << suffix << ": " << duration << " ms\n";
+    std::cout << "Kernel duration" << suffix << ": " << kernel_duration << " ms, " 
+              << gflops(kernel_duration, m, n, p) << " GFLOP/s\n" << std::endl;
+}
+
+// 与 host 结果比较；不一致时把两者及其差以 npy 格式保存到 matrix_device.npy、matrix_host.npy、matrix_diff.npy
+template <typename Mat>
+bool check_result(const std::string &label, const Mat &c_host, const Mat &c_device, my::equal<float> &eq) {
+    auto suffix = label.empty() ? std::string() : " (" + label + ")";
+    float max_error = 0;
+    for (auto p = c_host.begin(), q = c_device.begin(); p != c_host.end(); ++p, ++q)
+        max_error = std::max(max_error, std::abs(*p - *q));
+    std::cout << "Max error" << suffix << ": " << max_error << " (tolerance " << eq.tolerance << ")\n";
+    if (c_host.equal(c_device, eq))
+        return true;
+    std::cout << "Matrix multiplication failed on device" << suffix << ".\n";
+    Mat c_diff = c_host - c_device;
+    my::save_npy("matrix_device.npy", c_device);
+    my::save_npy("matrix_host.npy", c_host);
+    my::save_npy("matrix_diff.npy", c_diff);
+    std::cout << "Device output, host output and difference saved to matrix_{device,host,diff}.npy\n";
+    return false;
+}
  
-signed main() {
+// 一个 device kernel（或 host GEMM 变体）的输出及其验证容差；expected 非空时由 host 乘积计算参考结果，否则参考结果就是 host 乘积
+template <typename Mat>
+struct device_output {
+    std::string label;
+    Mat c;
+    float tolerance = 1e-4f;
+    std::function<Mat(const Mat &)> expected;
+};
 
-    static_assert(!(matrix_size % matrix_unit_size), "Matrix size must be a multiple of matrix unit size.");
-    static_assert(!(std::gcd(std::gcd(M, N), P) % matrix_unit_size), "Matrix size must be a multiple of matrix unit size.");
+// 按形状构造输出矩阵：mat 的形状在编译期确定，dyn_mat 需要运行时给出
+template <typename Mat>
+Mat make_output(int m, int p) {
+    if constexpr (std::is_same_v<Mat, my::dyn_mat<float>>)
+        return Mat(m, p);
+    else
+        return Mat();
+}
 
-    my::mat<float, M, N> a_host;
-    my::mat<float, N, P> b_host;
-    my::mat<float, M, P> c_out, c_out2;
-    a_host.random(), b_host.random();
+// 运行一个 host GEMM 变体并输出耗时，结果加入 outputs，与 device 输出一起验证
+template <typename Mat, typename F>
+void run_on_host(const std::string &label, int n, std::list<device_output<Mat>> &outputs, Mat c, F &&run) {
+    std::cout << "Running on host (" << label << ")...\n";
+    auto start = std::chrono::high_resolution_clock::now();
+    run(c);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Host duration (" << label << "): " 
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms, " 
+              << host_gflops(start, end, c.rows(), n, c.cols()) << " GFLOP/s\n" << std::endl;
+    outputs.push_back({label, std::move(c)});
+}
+
+// 命令行选项
+struct options {
+    std::vector<std::string> kernels;       // 为空时运行全部 kernel
+    bool host_scaling = false;
+    bool retune = false;
+    bool batched = false;
+    bool crossover = false;
+    bool sparse = false;
+    bool cpu = false;                       // 使用 CPU 设备
+    bool out_of_core = false;
+    bool multi_device = false;
+    bool transpose = false;
+    bool quantized = false;
+    bool full_check = false;                // 以 host 上完整计算的乘积逐元素验证，而不是 Freivalds 算法
+    double false_positive = 1e-6;           // Freivalds 验证的误判概率上界
+    std::size_t block = out_of_core_block;  // 外存 GEMM 的分块边长
+    std::size_t cutoff = strassen_cutoff;  // Strassen–Winograd 的截断大小
+    std::string a_path, b_path;             // 从文件（.npy 或 raw）加载 A、B
+    std::string c_path;                     // 把 host 乘积保存到文件，扩展名为 .npy 时使用 npy 格式
+
+    bool selected(const std::string &name) const {
+        return kernels.empty() || std::find(kernels.begin(), kernels.end(), name) != kernels.end();
+    }
+};
+
+// host GEMM 的 op = t 路径：在预先存放的 A^T、B^T 上以 op = t 调用 my::gemm，转置在打包时完成，结果应为 a * b
+// hint: 在 device 的 buffer 析构之后调用，此时 host 端可以自由访问 a_host、b_host
+template <typename MatA, typename MatB, typename Mat>
+void host_transposed(const MatA &a_host, const MatB &b_host, std::list<device_output<Mat>> &outputs, 
+                     const options &opts) {
+    const int m = a_host.rows(), n = a_host.cols(), p = b_host.cols();
+    if (opts.selected("trans_a")) {
+        auto a_t = !a_host;
+        run_on_host("Host, op(A) = T", n, outputs, make_output<Mat>(m, p), [&](Mat &c) {
+            my::gemm(my::op::t, my::op::n, m, n, p, a_t.begin(), m, b_host.begin(), p, c.begin(), p);
+        });
+    }
+    if (opts.selected("trans_b")) {
+        auto b_t = !b_host;
+        run_on_host("Host, op(B) = T", n, outputs, make_output<Mat>(m, p), [&](Mat &c) {
+            my::gemm(my::op::n, my::op::t, m, n, p, a_host.begin(), n, b_t.begin(), n, c.begin(), p);
+        });
+    }
+}
+
+// host 端的 2x2 分块视图：与 blocked_views 相同的分块，K 方向再分成两半，C_ij = A_i0 B_0j + A_i1 B_1j
+// 两项分别由 my::gemm 写入 C 与临时矩阵 T 中带行跨度的子块，再以表达式 C_ij = C_ij + T_ij 合并；
+// 最后把 C 经由视图赋值复制到 T，用 equal 逐元素比较，检查视图之间的赋值写入的是元素
+template <typename MatA, typename MatB, typename Mat>
+void host_views(const MatA &a_host, const MatB &b_host, std::list<device_output<Mat>> &outputs, const options &opts) {
+    if (!opts.selected("views")) return;
+    const int m = a_host.rows(), n = a_host.cols(), p = b_host.cols();
+    run_on_host("Host, 2x2 block views", n, outputs, make_output<Mat>(m, p), [&](Mat &c) {
+        auto partial = make_output<Mat>(m, p);
+        const int rows[] = {0, m / 2, m}, cols[] = {0, p / 2, p}, k = n / 2;
+        for (int i = 0; i < 2; i++)
+            for (int j = 0; j < 2; j++) {
+                const int height = rows[i + 1] - rows[i], width = cols[j + 1] - cols[j];
+                auto c_ij = c.block(rows[i], cols[j], height, width);
+                auto t_ij = partial.block(rows[i], cols[j], height, width);
+                my::gemm(a_host.block(rows[i], 0, height, k), b_host.block(0, cols[j], k, width), c_ij);
+                my::gemm(a_host.block(rows[i], k, height, n - k), b_host.block(k, cols[j], n - k, width), t_ij);
+                c_ij = c_ij + t_ij;
+            }
+        my::equal<float> eq;
+        partial.view() = c.view();
+        if (!c.equal(partial.view(), eq))
+            throw std::runtime_error("Matrix view assignment mismatch");
+    });
+}
+
+// 把 host 乘积保存到文件并输出耗时
+template <typename Mat>
+void save_output(const std::string &path, const Mat &c_host) {
+    auto save_start = std::chrono::high_resolution_clock::now();
+    my::save_matrix(path, c_host);
+    auto save_end = std::chrono::high_resolution_clock::now();
+    std::cout << "Host output saved to " << path << " in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(save_end - save_start).count() << " ms\n";
+}
+
+// 以 Freivalds 算法验证 c_device == a * b（见 my::freivalds）；失败时把 device 输出保存到 matrix_device.npy
+template <typename MatA, typename MatB, typename Mat>
+bool check_freivalds(const std::string &label, const MatA &a_host, const MatB &b_host, const Mat &c_device, 
+                     float tolerance, double false_positive) {
+    auto suffix = label.empty() ? std::string() : " (" + label + ")";
+    auto result = my::freivalds(a_host, b_host, c_device, tolerance, false_positive);
+    std::cout << "Freivalds check" << suffix << ": " << result.rounds << " rounds, max error " << result.max_error 
+              << " (tolerance " << result.tolerance << ")\n";
+    if (result.passed)
+        return true;
+    std::cout << "Matrix multiplication failed on device" << suffix << ".\n";
+    my::save_npy("matrix_device.npy", c_device);
+    std::cout << "Device output saved to matrix_device.npy\n";
+    return false;
+}
+
+// 验证全部 device 输出：默认以 Freivalds 算法随机验证，每个输出只需 O(n^2) 次运算
+// 需要由乘积变换出参考结果（expected）的输出，以一个以 float 精确计算（容差不超过默认值）且已通过验证的输出作为乘积，
+// 同样只需 O(n^2) 次运算；指定 full、需要保存 host 乘积或没有这样的输出时，才在 host 上完整计算 a * b
+template <typename MatA, typename MatB, typename Mat>
+void verify_outputs(const MatA &a_host, const MatB &b_host, std::list<device_output<Mat>> &outputs, 
+                    const options &opts) {
+    const int m = a_host.rows(), n = a_host.cols(), p = b_host.cols();
+    std::optional<Mat> c_host;
+    auto compute_product = [&] {
+        std::cout << "Running on host...\n";
+        auto host_start = std::chrono::high_resolution_clock::now();
+        c_host = a_host * b_host;
+        auto host_end = std::chrono::high_resolution_clock::now();
+        auto host_duration = std::chrono::duration_cast<std::chrono::milliseconds>(host_end - host_start).count();
+        std::cout << "Host duration: " << host_duration << " ms, " << host_gflops(host_start, host_end, m, n, p)
+                  << " GFLOP/s (" << my::host_threads() << " threads)\n" << std::endl;
+    };
+    if (opts.full_check || !opts.c_path.empty())
+        compute_product();
+
+    if (opts.host_scaling)
+        report_host_scaling(a_host, b_host);
+
+    auto verify_start = std::chrono::high_resolution_clock::now();
+    // hint: 先验证不需要参考结果的输出，遇到第一个失败的输出即停止
+    const Mat *product = c_host ? &*c_host : nullptr;
+    bool passed = true;
+    for (auto &output : outputs) {
+        if (output.expected) continue;
+        my::equal eq(output.tolerance);
+        passed = opts.full_check ? check_result(output.label, *c_host, output.c, eq)
+                                 : check_freivalds(output.label, a_host, b_host, output.c, output.tolerance, 
+                                                   opts.false_positive);
+        if (!passed) break;
+        if (product == nullptr && output.tolerance <= 1e-4f)
+            product = &output.c;
+    }
+    for (auto &output : outputs) {
+        if (!passed) break;
+        if (!output.expected) continue;
+        if (product == nullptr) {
+            std::cout << "No verified output to derive the reference results from.\n";
+            compute_product();
+            product = &*c_host;
+        }
+        my::equal eq(output.tolerance);
+        passed = check_result(output.label, output.expected(*product), output.c, eq);
+    }
+    if (passed)
+        std::cout << "Matrix multiplication succeeded on device.\n";
+    auto verify_end = std::chrono::high_resolution_clock::now();
+    std::cout << "Verification duration: " 
+              << std::chrono::duration_cast<std::chrono::milliseconds>(verify_end - verify_start).count() << " ms\n";
+
+    if (!opts.c_path.empty())
+        save_output(opts.c_path, *c_host);
+}
+
+// 创建运行 kernel 的队列：指定 cpu 时使用 CPU 设备，否则优先选择名称中含有 Intel(R) 的设备
+sycl::queue make_queue(const options &opts) {
+    if (opts.cpu)
+        return sycl::queue(sycl::cpu_selector_v, my::prop_list);
+    return sycl::queue(my::device_selector("Intel(R)"), my::prop_list);
+}
+
+// 运行时大小的矩阵乘法 c[m][p] = a[m][n] * b[n][p]，形状任意，不需要手动补齐
+void multiply_dynamic(my::dyn_mat<float> &a_host, my::dyn_mat<float> &b_host, const options &opts) {
+    if (a_host.cols() != b_host.rows())
+        throw std::runtime_error("Matrix shape mismatch");
+    const int m = a_host.rows(), n = a_host.cols(), p = b_host.cols();
+    my::dyn_mat<float> c0(m, p);
+    c0.random();
+    std::vector<float> bias(p);
+    auto epilogue = make_example_epilogue(n, bias);
+    // hint: 使用 list 保证元素地址稳定；每个输出的 buffer 在 run 返回时析构并写回 host
+    std::list<device_output<my::dyn_mat<float>>> outputs;
 
     my::print_platforms();
 
     try {
-        sycl::queue q(my::device_selector("Intel(R)"), my::prop_list);
+        auto q = make_queue(opts);
         std::cout << "Running on device: "
                   << q.get_device().get_info<sycl::info::device::name>() << "\n";
 
-        sycl::buffer<float, 2> a_buf(sycl::range(M, N));
-        sycl::buffer<float, 2> b_buf(sycl::range(N, P));
-        sycl::buffer c_buf(c_out.data(), sycl::range(M, P));
-        sycl::buffer c_buf2(c_out2.data(), sycl::range(M, P));
-        std::cout << "Problem size: " << "c[" << M << "][" << P << "] = a[" 
-                  << M << "][" << N << "] * b[" << N << "][" << P << "]\n\n";
+        std::cout << "Problem size: " << "c[" << m << "][" << p << "] = a[" 
+                  << m << "][" << n << "] * b[" << n << "][" << p << "]\n\n";
+        // hint: 容差需要读取 host 矩阵，在 use_host_ptr 的 buffer 包装它们之前计算
+        const auto half_tolerance = mixed_tolerance<sycl::half>(a_host, b_host);
+        const auto bf16_tolerance = mixed_tolerance<bfloat16>(a_host, b_host);
+        const auto strassen_tol = strassen_tolerance(a_host, b_host, opts.cutoff);
+        // hint: 预先存放 A^T、B^T，验证 op = t 时的 kernel 恰好把它们转置回来；转置同样读取 host 矩阵
+        std::optional<decltype(!a_host)> a_t;
+        std::optional<decltype(!b_host)> b_t;
+        if (opts.selected("trans_a") || opts.selected("trans_b"))
+            a_t = !a_host, b_t = !b_host;
+        // hint: C++17 的 lambda 不能捕获结构化绑定，这里用引用取出两个 buffer
+        auto operands = upload_operands(q, a_host, b_host);
+        auto &a_buf = operands.first, &b_buf = operands.second;
 
-        q.submit([&](sycl::handler &h) {
-            sycl::accessor a(a_buf, h, sycl::write_only);
-            auto p_a_host = a_host.data();
-            auto offset = a_host.get_offset();
-            h.parallel_for(sycl::range(M, N), [=](sycl::id<2> index) {
-                a[index] = p_a_host[offset(index[0], index[1])];
-            });
+        auto run = [&](const std::string &name, const std::string &label, auto &&kernel, float tolerance = 1e-4f,
+                       std::function<my::dyn_mat<float>(const my::dyn_mat<float> &)> expected = nullptr) {
+            if (!opts.selected(name)) return;
+            outputs.push_back({label, my::dyn_mat<float>(m, p), tolerance, expected});
+            auto &c_out = outputs.back().c;
+            auto c_buf = c_out.buffer();
+            run_on_device(label, [&] { return kernel(c_buf); }, m, n, p);
+        };
+
+        run("naive", "", [&](auto &c_buf) { return kernel(q, a_buf, b_buf, c_buf); });
+        run("tiled", "Tiled", [&](auto &c_buf) { return kernel2(q, a_buf, b_buf, c_buf); });
+        run("views", "Tiled, 2x2 block views", [&](auto &c_buf) { return blocked_views(q, a_buf, b_buf, c_buf); });
+        run("double", "Tiled, double-buffered", [&](auto &c_buf) { 
+            return kernel2_double_buffered(q, a_buf, b_buf, c_buf); 
         });
-        q.submit([&](sycl::handler &h) {
-            sycl::accessor b(b_buf, h, sycl::write_only);
-            auto p_b_host = b_host.data();
-            auto offset = b_host.get_offset();
-            h.parallel_for(sycl::range(N, P), [=](sycl::id<2> index) {
-                b[index] = p_b_host[offset(index[0], index[1])];
+        run("subgroup", "Sub-group", [&](auto &c_buf) { return subgroup_gemm(q, a_buf, b_buf, c_buf); });
+        if (opts.selected("blocked"))
+            std::cout << "Register blocked kernel requires compile-time sizes, skipped.\n\n";
+        if (opts.selected("tuned")) {
+            auto &config = tuned_config(q, a_buf, b_buf, opts.retune);
+            run("tuned", "Tuned " + config.name, [&](auto &c_buf) { return config.run(q, a_buf, b_buf, c_buf); });
+        }
+
+        run("half", "Half inputs", [&](auto &c_buf) { 
+            return mixed_precision<sycl::half>(q, a_buf, b_buf, c_buf); 
+        }, half_tolerance);
+        run("bf16", "Bfloat16 inputs", [&](auto &c_buf) { 
+            return mixed_precision<bfloat16>(q, a_buf, b_buf, c_buf); 
+        }, bf16_tolerance);
+        run("strassen", "Strassen-Winograd, cutoff " + std::to_string(opts.cutoff), [&](auto &c_buf) {
+            return strassen(q, a_buf, b_buf, c_buf, opts.cutoff);
+        }, strassen_tol);
+        run_fused_variants(run, q, a_buf, b_buf, c0, epilogue);
+        if (a_t.has_value()) {
+            auto a_t_buf = a_t->buffer();
+            auto b_t_buf = b_t->buffer();
+            run("trans_a", "Tiled, op(A) = T", [&](auto &c_buf) {
+                return transposed_gemm<my::op::t, my::op::n>(q, a_t_buf, b_buf, c_buf);
+            });
+            run("trans_b", "Tiled, op(B) = T", [&](auto &c_buf) {
+                return transposed_gemm<my::op::n, my::op::t>(q, a_buf, b_t_buf, c_buf);
             });
+        }
+
+    } catch (sycl::exception const &e) {
+        std::cout << "An exception is caught for matrix multiplication.\n";
+        std::terminate();
+    }
+
+    host_transposed(a_host, b_host, outputs, opts);
+    host_views(a_host, b_host, outputs, opts);
+    verify_outputs(a_host, b_host, outputs, opts);
+}
+
+void multiply_dynamic(int m, int n, int p, const options &opts) {
+    my::dyn_mat<float> a_host(m, n), b_host(n, p);
+    a_host.random(), b_host.random();
+    multiply_dynamic(a_host, b_host, opts);
+}
+
+// 从文件加载 A、B 后计算；文件通过内存映射读入，只在复制为 dyn_mat 时访问一遍
+void multiply_files(const options &opts) {
+    auto load_start = std::chrono::high_resolution_clock::now();
+    auto a_host = my::load_matrix<float>(opts.a_path);
+    auto b_host = my::load_matrix<float>(opts.b_path);
+    auto load_end = std::chrono::high_resolution_clock::now();
+    std::cout << "Loaded " << opts.a_path << " (" << a_host.rows() << "x" << a_host.cols() << ") and " 
+              << opts.b_path << " (" << b_host.rows() << "x" << b_host.cols() << ") in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(load_end - load_start).count() << " ms\n";
+    multiply_dynamic(a_host, b_host, opts);
+}
+
+// 把 CPU 设备按亲和域（NUMA 节点等）划分为子设备，不支持时按计算单元平分为两个；不是 CPU 或无法划分时返回设备本身
+std::vector<sycl::device> partition_cpu(const sycl::device &device) {
+    if (!device.is_cpu() || device.get_info<sycl::info::device::partition_max_sub_devices>() < 2)
+        return {device};
+    try {
+        auto sub_devices = device.create_sub_devices<sycl::info::partition_property::partition_by_affinity_domain>(
+            sycl::info::partition_affinity_domain::next_partitionable);
+        if (sub_devices.size() > 1)
+            return sub_devices;
+    } catch (sycl::exception const &e) {}
+    try {
+        auto units = device.get_info<sycl::info::device::max_compute_units>();
+        return device.create_sub_devices<sycl::info::partition_property::partition_equally>(std::max(1u, units / 2));
+    } catch (sycl::exception const &e) {}
+    return {device};
+}
+
+// 多设备 GEMM 使用的设备：my::get_devices() 中的全部设备，CPU 设备替换为它的子设备
+// hint: 同一设备可能经由多个后端的平台出现，按名称去重
+std::vector<sycl::device> usable_devices() {
+    std::vector<sycl::device> devices;
+    std::vector<std::string> names;
+    for (auto &platform : my::get_devices()) {
+        for (auto &info : platform.devices) {
+            if (std::find(names.begin(), names.end(), info.name) != names.end())
+                continue;
+            names.push_back(info.name);
+            auto parts = partition_cpu(info.device);
+            devices.insert(devices.end(), parts.begin(), parts.end());
+        }
+    }
+    return devices;
+}
+
+// 多设备 GEMM：C 按行分块，各设备分到的行数与其实测吞吐量成正比，每个设备一个队列、一个 host 线程并发计算
+// 吞吐量由各设备计算 A 的前 calibration_rows 行得到；输出每个设备的耗时与负载不均衡程度
+void multiply_multi_device(int m, int n, int p) {
+    my::dyn_mat<float> a_host(m, n), b_host(n, p), c_device(m, p);
+    a_host.random(), b_host.random();
+    const int calibration_rows = std::min(m, 256);
+
+    my::print_platforms();
+    std::cout << "Problem size: " << "c[" << m << "][" << p << "] = a[" 
+              << m << "][" << n << "] * b[" << n << "][" << p << "]\n\n";
+    try {
+        std::vector<sycl::queue> queues;
+        for (auto &device : usable_devices())
+            queues.emplace_back(device, my::prop_list);
+
+        // hint: A、B 在各设备上都只读，每个设备各自以 const 指针构造 buffer（不写回），
+        // 不让多个 use_host_ptr 的 buffer 同时包装同一块 host 存储
+        const float *a_data = a_host.data(), *b_data = b_host.data();
+
+        // 校准失败的设备（例如 kernel 无法在某个后端上构建）不参与分配
+        std::vector<double> rates;
+        std::vector<sycl::queue> calibrated;
+        std::cout << "Calibrating on " << calibration_rows << " rows...\n";
+        for (auto &queue : queues) {
+            const auto name = queue.get_device().get_info<sycl::info::device::name>();
+            try {
+                my::dyn_mat<float> c_sample(calibration_rows, p);
+                auto a_buf = my::make_buffer(a_data, calibration_rows, n);
+                auto b_buf = my::make_buffer(b_data, n, p);
+                auto c_buf = c_sample.buffer();
+                kernel2(queue, a_buf, b_buf, c_buf);    // 预热，排除 JIT 编译的耗时
+                // hint: 计时精度不足时耗时可能为 0，按 1 ns 计
+                auto duration = std::max(kernel2(queue, a_buf, b_buf, c_buf), 1e-6);
+                rates.push_back(calibration_rows / duration);
+                std::cout << "  [" << calibrated.size() << "] " << name << ": " 
+                          << gflops(duration, calibration_rows, n, p) << " GFLOP/s\n";
+                calibrated.push_back(queue);
+            } catch (sycl::exception const &e) {
+                std::cout << "  " << name << ": " << e.what() << ", skipped\n";
+            }
+        }
+        queues = std::move(calibrated);
+        const int count = queues.size();
+        if (count == 0) {
+            std::cout << "No device completed the calibration.\n\n";
+            return;
+        }
+
+        // hint: 各设备的行数取 matrix_unit_size 的倍数，余下的行都交给最后一个设备
+        std::vector<int> first_row(count + 1, 0);
+        const double total_rate = std::accumulate(rates.begin(), rates.end(), 0.0);
+        for (int i = 0; i < count; i++) {
+            int rows = i + 1 < count ? int(round_up(std::size_t(m * rates[i] / total_rate))) : m;
+            first_row[i + 1] = std::min(m, first_row[i] + rows);
+        }
+
+        // hint: 运行中出错的设备记录下来，它分到的行在 host 上补算，异常不能离开工作线程
+        std::vector<double> kernel_durations(count), durations(count);
+        std::vector<std::string> errors(count);
+        auto start = std::chrono::high_resolution_clock::now();
+        my::host_parallel_for(count, count, [&](int i) {
+            const int rows = first_row[i + 1] - first_row[i];
+            if (rows == 0) return;
+            auto device_start = std::chrono::high_resolution_clock::now();
+            try {
+                auto a_buf = my::make_buffer(a_data + std::size_t(first_row[i]) * n, rows, n);
+                auto b_buf = my::make_buffer(b_data, n, p);
+                auto c_buf = my::make_buffer(c_device[first_row[i]], rows, p);
+                kernel_durations[i] = kernel2(queues[i], a_buf, b_buf, c_buf);
+            } catch (sycl::exception const &e) {
+                errors[i] = e.what();
+            }
+            auto device_end = std::chrono::high_resolution_clock::now();
+            durations[i] = std::chrono::duration<double, std::milli>(device_end - device_start).count();
+        });
+        for (int i = 0; i < count; i++) {
+            if (errors[i].empty()) continue;
+            const int rows = first_row[i + 1] - first_row[i];
+            std::cout << "  [" << i << "] " << errors[i] << ", rows " << first_row[i] << ".." << first_row[i + 1] 
+                      << " computed on host\n";
+            my::gemm(rows, n, p, a_data + std::size_t(first_row[i]) * n, n, b_data, p, c_device[first_row[i]], p);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration<double, std::milli>(end - start).count();
+
+        std::cout << "\nMulti-device run on " << count << " devices:\n";
+        double busiest = 0, busy_total = 0;
+        for (int i = 0; i < count; i++) {
+            const int rows = first_row[i + 1] - first_row[i];
+            std::cout << "  [" << i << "] rows " << first_row[i] << ".." << first_row[i + 1] << " (" 
+                      << 100.0 * rows / m << "%): " << durations[i] << " ms, kernel " << kernel_durations[i] << " ms\n";
+            busiest = std::max(busiest, durations[i]), busy_total += durations[i];
+        }
+        std::cout << "Multi-device duration: " << duration << " ms, " << gflops(duration, m, n, p) << " GFLOP/s\n";
+        std::cout << "Load imbalance (slowest / mean - 1): " << (busiest / (busy_total / count) - 1) * 100 << "%\n\n";
+    } catch (sycl::exception const &e) {
+        std::cout << "An exception is caught for multi-device matrix multiplication.\n";
+        std::terminate();
+    }
+
+    auto c_host = a_host * b_host;
+    my::equal eq(1e-4f);
+    if (check_result("Multi-device", c_host, c_device, eq))
+        std::cout << "Multi-device matrix multiplication succeeded.\n";
+    std::cout << std::endl;
+}
+
+// 批量 GEMM 基准：batch 个 size x size 的乘积，分别用跨步批量、指针数组批量各提交一次，
+// 以及对每个乘积单独调用一次 kernel2（每次一个 submit 加一次 wait）
+void batched_benchmark(int batch, int size) {
+    // hint: batch 个矩阵纵向堆叠成一个 (batch * size) x size 的矩阵，第 i 个矩阵从第 i * size 行开始
+    my::dyn_mat<float> a_host(batch * size, size), b_host(batch * size, size);
+    my::dyn_mat<float> c_strided(batch * size, size), c_array(batch * size, size), c_loop(batch * size, size);
+    a_host.random(), b_host.random();
+    const std::size_t stride = std::size_t(size) * size;
+    const double flop = 2.0 * batch * stride * size;
+
+    std::cout << "Batched GEMM: " << batch << " x (" << size << " x " << size << ")\n";
+    try {
+        sycl::queue q(my::device_selector("Intel(R)"), my::prop_list);
+        auto a = sycl::malloc_device<float>(a_host.size(), q);
+        auto b = sycl::malloc_device<float>(b_host.size(), q);
+        auto c = sycl::malloc_device<float>(c_strided.size(), q);
+        q.memcpy(a, a_host.data(), a_host.size_of());
+        q.memcpy(b, b_host.data(), b_host.size_of());
+        q.wait();
+
+        auto report = [&](const std::string &label, auto &&run) {
+            run();  // 预热，排除 JIT 编译的耗时
+            auto start = std::chrono::high_resolution_clock::now();
+            auto kernel_duration = run();
+            auto end = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration<double, std::milli>(end - start).count();
+            std::cout << "  " << label << ": " << duration << " ms total, " << kernel_duration << " ms in kernels, "
+                      << flop / (duration * 1e6) << " GFLOP/s\n";
+        };
+        auto event_duration = [](sycl::event &event) {
+            auto start = event.get_profiling_info<sycl::info::event_profiling::command_start>();
+            auto end = event.get_profiling_info<sycl::info::event_profiling::command_end>();
+            return (end - start) * 1e-6;
+        };
+
+        report("Strided batch (1 launch)", [&] {
+            auto event = gemm_batched_strided(q, size, size, size, batch, a, stride, b, stride, c, stride);
+            event.wait();
+            return event_duration(event);
         });
+        q.memcpy(c_strided.data(), c, c_strided.size_of()).wait();
 
-        std::cout << "Running on device...\n";
+        std::vector<const float *> a_ptrs(batch), b_ptrs(batch);
+        std::vector<float *> c_ptrs(batch);
+        for (int i = 0; i < batch; i++)
+            a_ptrs[i] = a + i * stride, b_ptrs[i] = b + i * stride, c_ptrs[i] = c + i * stride;
+        auto a_array = sycl::malloc_device<const float *>(batch, q);
+        auto b_array = sycl::malloc_device<const float *>(batch, q);
+        auto c_array_ptr = sycl::malloc_device<float *>(batch, q);
+        q.memcpy(a_array, a_ptrs.data(), batch * sizeof(float *));
+        q.memcpy(b_array, b_ptrs.data(), batch * sizeof(float *));
+        q.memcpy(c_array_ptr, c_ptrs.data(), batch * sizeof(float *));
+        q.memset(c, 0, c_strided.size_of());
+        q.wait();
+        report("Pointer array batch (1 launch)", [&] {
+            auto event = gemm_batched(q, size, size, size, batch, a_array, b_array, c_array_ptr);
+            event.wait();
+            return event_duration(event);
+        });
+        q.memcpy(c_array.data(), c, c_array.size_of()).wait();
+
+        {
+            std::vector<sycl::buffer<float, 2>> a_bufs, b_bufs, c_bufs;
+            for (int i = 0; i < batch; i++) {
+                a_bufs.emplace_back(a_host[i * size], sycl::range(size, size));
+                b_bufs.emplace_back(b_host[i * size], sycl::range(size, size));
+                c_bufs.emplace_back(c_loop[i * size], sycl::range(size, size));
+            }
+            report("Loop of kernel2 (" + std::to_string(batch) + " launches)", [&] {
+                double kernel_duration = 0;
+                for (int i = 0; i < batch; i++)
+                    kernel_duration += kernel2(q, a_bufs[i], b_bufs[i], c_bufs[i]);
+                return kernel_duration;
+            });
+        }
+
+        sycl::free(a_array, q), sycl::free(b_array, q), sycl::free(c_array_ptr, q);
+        sycl::free(a, q), sycl::free(b, q), sycl::free(c, q);
+    } catch (sycl::exception const &e) {
+        std::cout << "An exception is caught for batched matrix multiplication.\n";
+        std::terminate();
+    }
+
+    my::dyn_mat<float> c_host(batch * size, size);
+    for (int i = 0; i < batch; i++)
+        my::gemm(size, size, size, a_host[i * size], size, b_host[i * size], size, c_host[i * size], size);
+    my::equal eq(1e-4f);
+    if (check_result("Strided batch", c_host, c_strided, eq) && check_result("Pointer array batch", c_host, c_array, eq) &&
+        check_result("Loop of kernel2", c_host, c_loop, eq)) {
+        std::cout << "Batched matrix multiplication succeeded on device.\n";
+    }
+    std::cout << std::endl;
+}
+
+// Strassen–Winograd 基准：在一系列方阵大小上对比 tiled kernel、单层递归与按 cutoff 完整递归的 kernel 耗时，
+// 并用 my::equal 比较各自相对 host 结果的误差；单层递归开始快于 tiled kernel 的大小即为合适的 cutoff
+void strassen_benchmark(std::size_t cutoff) {
+    std::cout << "Strassen-Winograd crossover (cutoff " << cutoff << ")\n";
+    try {
+        sycl::queue q(my::device_selector("Intel(R)"), my::prop_list);
+        std::optional<std::size_t> crossover;
+        for (std::size_t size = 256; size <= 4096; size *= 2) {
+            my::dyn_mat<float> a_host(size, size), b_host(size, size), c_host(size, size);
+            a_host.random(), b_host.random();
+            my::gemm(int(size), int(size), int(size), a_host.data(), int(size), b_host.data(), int(size), 
+                     c_host.data(), int(size));
+            my::equal eq(1e-4f);
+            auto measure = [&](std::size_t cut) {
+                my::dyn_mat<float> c(size, size);
+                double duration;
+                {
+                    auto a_buf = a_host.buffer(), b_buf = b_host.buffer(), c_buf = c.buffer();
+                    strassen(q, a_buf, b_buf, c_buf, cut, false);     // 预热，排除 JIT 编译的耗时
+                    duration = strassen(q, a_buf, b_buf, c_buf, cut, false);
+                }   // buffer 析构时把结果写回 c
+                float max_error = 0;
+                for (auto p = c_host.begin(), r = c.begin(); p != c_host.end(); ++p, ++r)
+                    max_error = std::max(max_error, std::abs(*p - *r));
+                return std::make_tuple(duration, max_error, c_host.equal(c, eq));
+            };
+            auto report = [&](const std::string &label, std::tuple<double, float, bool> result) {
+                auto [duration, max_error, passed] = result;
+                std::cout << "    " << std::setw(18) << std::left << label << std::right << duration << " ms, " 
+                          << gflops(duration, size, size, size) << " GFLOP/s, max error " << max_error 
+                          << (passed ? "" : " (exceeds 1e-4)") << "\n";
+                return duration;
+            };
+            std::cout << "  " << size << "x" << size << ":\n";
+            auto tiled = report("Tiled", measure(size));
+            auto one_level = report("1 level", measure(size / 2));
+            report("Cutoff " + std::to_string(cutoff), measure(cutoff));
+            if (!crossover.has_value() && one_level < tiled)
+                crossover = size;
+        }
+        if (crossover.has_value())
+            std::cout << "Crossover: one Strassen-Winograd level beats the tiled kernel from " << *crossover 
+                      << "x" << *crossover << "; use cutoff=" << *crossover / 2 << "\n";
+        else std::cout << "Crossover: the tiled kernel is faster at every measured size\n";
+    } catch (sycl::exception const &e) {
+        std::cout << "An exception is caught for Strassen-Winograd matrix multiplication.\n";
+        std::terminate();
+    }
+    std::cout << std::endl;
+}
+
+// 外存 GEMM 基准：A、B、C 存放在当前目录的 ooc_a.bin、ooc_b.bin、ooc_c.bin 中（行主序 float，无文件头）
+// 大小不符的 A、B 文件会用随机数重新生成；结果按若干抽样行与 host GEMM 比较
+void out_of_core_benchmark(std::size_t m, std::size_t n, std::size_t p, std::size_t block) {
+    const std::string a_path = "ooc_a.bin", b_path = "ooc_b.bin", c_path = "ooc_c.bin";
+    auto prepare = [](const std::string &path, std::size_t rows, std::size_t cols) {
+        if (my::mapped_file::file_size(path) == sizeof(float) * rows * cols)
+            return;
+        std::cout << "Generating " << path << " (" << rows << " x " << cols << ")...\n";
+        my::mapped_file file(path, sizeof(float) * rows * cols);
+        my::rand<float> rand(0, 1);
+        std::generate_n(file.data<float>(), rows * cols, std::ref(rand));
+    };
+    prepare(a_path, m, n);
+    prepare(b_path, n, p);
+
+    my::mapped_file a_file(a_path), b_file(b_path), c_file(c_path, sizeof(float) * m * p);
+    auto a = a_file.data<float>(), b = b_file.data<float>();
+    auto c = c_file.data<float>();
+    const double working_set = sizeof(float) * 5.0 * block * block / (1024 * 1024);
+    std::cout << "Out-of-core GEMM: c[" << m << "][" << p << "] = a[" << m << "][" << n << "] * b[" << n << "][" 
+              << p << "], " << double(a_file.size() + b_file.size() + c_file.size()) / (1024 * 1024) << " MiB on disk, " 
+              << "block " << block << ", device working set " << working_set << " MiB\n";
+
+    try {
+        sycl::queue q(my::device_selector("Intel(R)"), my::prop_list);
         auto start = std::chrono::high_resolution_clock::now();
-        auto kernel_duration = kernel(q, a_buf, b_buf, c_buf);
+        auto kernel_duration = out_of_core_gemm(q, a, b, c, m, n, p, block);
         auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-        std::cout << "Device duration: " << duration << " ms\n";
-        std::cout << "Kernel duration: " << kernel_duration << " ms\n" << std::endl;
-
-        std::cout << "Running on device (Tiled)...\n";
-        start = std::chrono::high_resolution_clock::now();
-        kernel_duration = kernel2(q, a_buf, b_buf, c_buf2);
-        end = std::chrono::high_resolution_clock::now();
-        duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-        std::cout << "Device duration (Tiled): " << duration << " ms\n";
-        std::cout << "Kernel duration (Tiled): " << kernel_duration << " ms\n" << std::endl;
+        auto duration = std::chrono::duration<double, std::milli>(end - start).count();
+        std::cout << "Out-of-core duration: " << duration << " ms, " << gflops(duration, m, n, p) << " GFLOP/s\n";
+        std::cout << "Kernel duration: " << kernel_duration << " ms, " << gflops(kernel_duration, m, n, p) 
+                  << " GFLOP/s; streaming keeps " << kernel_duration / duration * 100 << "% of kernel throughput\n";
+    } catch (sycl::exception const &e) {
+        std::cout << "An exception is caught for out-of-core matrix multiplication.\n";
+        std::terminate();
+    }
+
+    // hint: 完整的 host 结果同样放不进内存，只抽查首尾与均匀分布的若干行；C 没有行时不抽查
+    const int samples = m > 0 ? 8 : 0;
+    my::equal eq(std::max(1e-4f, std::numeric_limits<float>::epsilon() * n));
+    float max_error = 0;
+    bool succeeded = true;
+    std::vector<float> row(p);
+    for (int s = 0; s < samples; s++) {
+        auto r = (m - 1) * s / (samples - 1);
+        my::gemm(1, int(n), int(p), a + r * n, int(n), b, int(p), row.data(), int(p));
+        for (std::size_t j = 0; j < p; j++) {
+            max_error = std::max(max_error, std::abs(row[j] - c[r * p + j]));
+            succeeded = succeeded && eq(row[j], c[r * p + j]);
+        }
+    }
+    std::cout << "Max error (" << samples << " sampled rows): " << max_error << " (tolerance " << eq.tolerance << ")\n";
+    if (succeeded)
+        std::cout << "Out-of-core matrix multiplication succeeded on device.\n";
+    else std::cout << "Out-of-core matrix multiplication failed on device.\n";
+    std::cout << std::endl;
+}
 
+// 稀疏矩阵基准：size x size 的 A 在不同密度下分别以稠密、CSR、Sliced ELL 格式做 SpMV，
+// 以稠密 kernel2、CSR 做 SpMM（B 为 size x columns），输出耗时、有效带宽与相对稠密路径的加速比
+// 有效带宽 = 必须读写的字节数 / 耗时：A 的存储（稠密或压缩格式）、x 或 B 读一次、y 或 C 写一次
+void sparse_benchmark(int size, int columns) {
+    constexpr double densities[] = {0.5, 0.2, 0.05, 0.01, 0.001};
+    constexpr std::size_t mib = 1024 * 1024;
+    constexpr int slice_height = 32;
+    const std::size_t vectors = sizeof(float) * 2 * size, panels = sizeof(float) * 2 * std::size_t(size) * columns;
+    // hint: 各路径的累加顺序相同但可能使用 FMA，结果按 K 项累加的舍入误差比较
+    my::equal eq(std::max(1e-4f, std::numeric_limits<float>::epsilon() * size));
+    my::rand<float> mask(0, 1);
+    bool succeeded = true;
+
+    std::cout << "Sparse matrix: " << size << " x " << size << ", SpMM with " << columns << " columns\n";
+    try {
+        sycl::queue q(my::device_selector("Intel(R)"), my::prop_list);
+        for (auto density : densities) {
+            my::dyn_mat<float> a_host(size, size), x_host(size, 1), b_host(size, columns);
+            a_host.random(), x_host.random(), b_host.random();
+            for (auto &value : a_host)
+                if (mask() >= density) value = 0;
+            my::csr_mat<float> csr(a_host);
+            my::sell_mat<float> sell(csr, slice_height);
+            std::cout << "  Density " << csr.density() << " (nnz " << csr.nnz() << ", dense " << double(a_host.size_of()) / mib 
+                      << " MiB, CSR " << double(csr.size_of()) / mib << " MiB, SELL-" << slice_height << " " 
+                      << double(sell.size_of()) / mib << " MiB):\n";
+
+            // dense 为 true 的路径作为之后各路径计算加速比的基准
+            double dense_duration = 0;
+            auto report = [&](const std::string &label, std::size_t bytes, auto &&run, bool dense = false) {
+                run();  // 预热，排除 JIT 编译的耗时
+                auto duration = run();
+                if (dense) dense_duration = duration;
+                std::cout << "    " << std::setw(18) << std::left << label << std::right << duration << " ms, " 
+                          << bytes / (duration * 1e6) << " GB/s effective, speedup " << dense_duration / duration << "\n";
+            };
+
+            my::dyn_mat<float> y_dense(size, 1), y_csr(size, 1), y_sell(size, 1);
+            my::dyn_mat<float> c_dense(size, columns), c_csr(size, columns);
+            {
+                auto a_buf = a_host.buffer(), b_buf = b_host.buffer();
+                auto c_dense_buf = c_dense.buffer(), c_csr_buf = c_csr.buffer();
+                sycl::buffer<float> x_buf(x_host.data(), sycl::range<1>(size));
+                sycl::buffer<float> y_dense_buf(y_dense.data(), sycl::range<1>(size));
+                sycl::buffer<float> y_csr_buf(y_csr.data(), sycl::range<1>(size));
+                sycl::buffer<float> y_sell_buf(y_sell.data(), sycl::range<1>(size));
+                auto csr_bufs = csr.buffers();
+                auto sell_bufs = sell.buffers();
+
+                report("Dense SpMV", a_host.size_of() + vectors, [&] { 
+                    return gemv(q, a_buf, x_buf, y_dense_buf); 
+                }, true);
+                report("CSR SpMV", csr.size_of() + vectors, [&] { return spmv_csr(q, csr_bufs, x_buf, y_csr_buf); });
+                report("SELL SpMV", sell.size_of() + vectors, [&] { 
+                    return spmv_sell(q, sell_bufs, slice_height, x_buf, y_sell_buf); 
+                });
+                report("Dense SpMM", a_host.size_of() + panels, [&] { 
+                    return kernel2(q, a_buf, b_buf, c_dense_buf); 
+                }, true);
+                report("CSR SpMM", csr.size_of() + panels, [&] { return spmm_csr(q, csr_bufs, b_buf, c_csr_buf); });
+            }
+
+            my::dyn_mat<float> y_host(size, 1), c_host(size, columns);
+            my::gemm(size, size, 1, a_host.data(), size, x_host.data(), 1, y_host.data(), 1);
+            my::gemm(size, size, columns, a_host.data(), size, b_host.data(), columns, c_host.data(), columns);
+            succeeded = check_result("Dense SpMV", y_host, y_dense, eq) && check_result("CSR SpMV", y_host, y_csr, eq) &&
+                        check_result("SELL SpMV", y_host, y_sell, eq) && check_result("Dense SpMM", c_host, c_dense, eq) &&
+                        check_result("CSR SpMM", c_host, c_csr, eq) && succeeded;
+        }
     } catch (sycl::exception const &e) {
-        std::cout << "An exception is caught for matrix multiplication.\n";
+        std::cout << "An exception is caught for sparse matrix multiplication.\n";
+        std::terminate();
+    }
+    if (succeeded)
+        std::cout << "Sparse matrix multiplication succeeded on device.\n";
+    std::cout << std::endl;
+}
+
+// 量化 GEMM 基准：A 量化为 uint8（按行），B 量化为 int8（按列），与 float 的 kernel2 对比耗时
+// 整数结果与 host 参考实现逐元素精确比较；另外输出反量化结果相对 float 乘积的量化误差
+// N 超过 my::quantized_max_k（int32 累加不溢出的上限）时抛出异常
+void quantized_benchmark(int m, int n, int p) {
+    my::check_quantized_k(n);
+    my::dyn_mat<float> a_host(m, n), b_host(n, p), c_float(m, p);
+    my::rand<float> rand(-1, 1);
+    std::generate(a_host.begin(), a_host.end(), std::ref(rand));
+    std::generate(b_host.begin(), b_host.end(), std::ref(rand));
+    auto a_q = my::quantize<std::uint8_t>(a_host, true);
+    auto b_q = my::quantize<std::int8_t>(b_host, false);
+    auto a_packed = a_q.packed_k(), b_packed = b_q.packed_k();
+    my::dyn_mat<std::int32_t> c_int(m, p);
+    my::dyn_mat<float> c_device(m, p);
+
+    std::cout << "Quantized GEMM: c[" << m << "][" << p << "] = a[" << m << "][" << n << "] (uint8, per-row) * b[" 
+              << n << "][" << p << "] (int8, per-column)\n";
+    try {
+        sycl::queue q(my::device_selector("Intel(R)"), my::prop_list);
+        std::cout << "Running on device: " << q.get_device().get_info<sycl::info::device::name>() << "\n";
+        auto a_buf = a_host.buffer(), b_buf = b_host.buffer(), c_float_buf = c_float.buffer();
+        auto a_packed_buf = a_packed.buffer(), b_packed_buf = b_packed.buffer();
+        auto c_int_buf = c_int.buffer();
+        auto c_buf = c_device.buffer();
+        auto a_params = a_q.buffers(), b_params = b_q.buffers();
+        auto report = [&](const std::string &label, auto &&run) {
+            run();  // 预热，排除 JIT 编译的耗时
+            auto duration = run();
+            std::cout << "  " << std::setw(14) << std::left << label << std::right << duration << " ms, " 
+                      << gflops(duration, m, n, p) << " GOP/s\n";
+        };
+        report("Float tiled", [&] { return kernel2(q, a_buf, b_buf, c_float_buf); });
+        report("Int8 packed", [&] { 
+            return quantized_kernel<std::uint8_t, std::int8_t>(q, a_packed_buf, a_params, b_packed_buf, b_params, n, 
+                                                               c_int_buf, c_buf); 
+        });
+    } catch (sycl::exception const &e) {
+        std::cout << "An exception is caught for quantized matrix multiplication.\n";
         std::terminate();
     }
 
-    std::cout << "Running on host...\n";
     auto host_start = std::chrono::high_resolution_clock::now();
-    auto c_host = a_host * b_host;
+    auto c_host = my::quantized_gemm(a_q, b_q);
     auto host_end = std::chrono::high_resolution_clock::now();
-    auto host_duration = std::chrono::duration_cast<std::chrono::milliseconds>(host_end - host_start).count();
-    std::cout << "Host duration: " << host_duration << " ms\n" << std::endl;
+    std::cout << "Host reference duration: " << std::chrono::duration<double, std::milli>(host_end - host_start).count() 
+              << " ms\n";
 
-    my::equal eq(1e-4f);
-    if (!c_host.equal(c_out, eq)) {
-        std::cout << "Matrix multiplication failed on device.\n";
-        std::ofstream ofs("matrix.txt");
-        ofs << "Device output:\n";
-        c_out.print_to(ofs) << std::endl;
-        ofs << "Host output:\n";
-        c_host.print_to(ofs) << std::endl;
-        auto c_diff = c_host - c_out;
-        ofs << "Difference:\n";
-        c_diff.print_to(ofs) << std::endl;
-        ofs.close();
-    } else if (!c_host.equal(c_out2, eq)) {
-        std::cout << "Matrix multiplication failed on device (Tiled).\n";
-        std::ofstream ofs("matrix.txt");
-        ofs << "Device output (Tiled):\n";
-        c_out2.print_to(ofs) << std::endl;
-        ofs << "Host output:\n";
-        c_host.print_to(ofs) << std::endl;
-        auto c_diff = c_host - c_out2;
-        ofs << "Difference:\n";
-        c_diff.print_to(ofs) << std::endl;
-        ofs.close();
-    } else {
-        std::cout << "Matrix multiplication succeeded on device.\n";
+    bool exact = std::equal(c_int.begin(), c_int.end(), c_host.begin());
+    // hint: 反量化是两次乘法，允许 device 以不同的结合顺序计算时相差几个 ulp
+    float max_value = 0, max_error = 0, quantization_error = 0;
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < p; j++) {
+            float expected = a_q.scale[i] * b_q.scale[j] * float(c_host[i][j]);
+            max_value = std::max(max_value, std::abs(expected));
+            max_error = std::max(max_error, std::abs(expected - c_device[i][j]));
+            quantization_error = std::max(quantization_error, std::abs(expected - c_float[i][j]));
+        }
+    bool dequantized = max_error <= 4 * std::numeric_limits<float>::epsilon() * max_value;
+    std::cout << "Integer result " << (exact ? "matches" : "does not match") << " the host reference exactly\n"
+              << "Max dequantization error: " << max_error << ", max quantization error vs float: " 
+              << quantization_error << " (max |c| " << max_value << ")\n";
+    if (exact && dequantized)
+        std::cout << "Quantized matrix multiplication succeeded on device.\n";
+    else std::cout << "Quantized matrix multiplication failed on device.\n";
+    std::cout << std::endl;
+}
+
+// 转置带宽基准：host 上比较朴素双重循环、缓存无关的并行转置与并行复制，device 上比较朴素转置、分块转置与复制
+// 带宽按读、写各一遍矩阵计算
+void transpose_benchmark(int rows, int cols) {
+    const double bytes = 2.0 * sizeof(float) * rows * cols;
+    my::dyn_mat<float> a_host(rows, cols), copy_host(rows, cols), naive_host(cols, rows), t_host(cols, rows);
+    a_host.random();
+
+    std::cout << "Transpose: " << rows << " x " << cols << "\n";
+    auto report = [&](const std::string &label, double duration) {
+        std::cout << "  " << std::setw(20) << std::left << label << std::right << duration << " ms, " 
+                  << bytes / (duration * 1e6) << " GB/s\n";
+    };
+    // hint: 取第二次运行的耗时，排除首次访问目标内存时缺页与 kernel JIT 编译的开销
+    auto host_report = [&](const std::string &label, auto &&run) {
+        run();
+        auto start = std::chrono::high_resolution_clock::now();
+        run();
+        auto end = std::chrono::high_resolution_clock::now();
+        report(label, std::chrono::duration<double, std::milli>(end - start).count());
+    };
+
+    const int threads = my::host_threads();
+    host_report("Host copy", [&] {
+        my::host_parallel_for(threads, threads, [&](int t) {
+            auto first = std::size_t(rows) * cols * t / threads, last = std::size_t(rows) * cols * (t + 1) / threads;
+            std::copy(a_host.begin() + first, a_host.begin() + last, copy_host.begin() + first);
+        });
+    });
+    host_report("Host naive", [&] {
+        for (int i = 0; i < rows; i++)
+            for (int j = 0; j < cols; j++)
+                naive_host[j][i] = a_host[i][j];
+    });
+    host_report("Host blocked", [&] { 
+        my::transpose(rows, cols, a_host.begin(), cols, t_host.begin(), rows, threads); 
+    });
+    bool succeeded = std::equal(t_host.begin(), t_host.end(), naive_host.begin());
+
+    my::dyn_mat<float> copy_device(rows, cols), naive_device(cols, rows), t_device(cols, rows);
+    try {
+        sycl::queue q(my::device_selector("Intel(R)"), my::prop_list);
+        std::cout << "  Running on device: " << q.get_device().get_info<sycl::info::device::name>() << "\n";
+        auto a_buf = a_host.buffer(), copy_buf = copy_device.buffer();
+        auto naive_buf = naive_device.buffer(), t_buf = t_device.buffer();
+        auto device_report = [&](const std::string &label, auto &&run) {
+            run();
+            report(label, run());
+        };
+        device_report("Device copy", [&] { return copy_kernel(q, a_buf, copy_buf); });
+        device_report("Device naive", [&] { return naive_transpose(q, a_buf, naive_buf); });
+        device_report("Device tiled", [&] { return tiled_transpose(q, a_buf, t_buf); });
+    } catch (sycl::exception const &e) {
+        std::cout << "An exception is caught for matrix transpose.\n";
+        std::terminate();
+    }
+    succeeded = succeeded && std::equal(copy_device.begin(), copy_device.end(), a_host.begin()) &&
+                std::equal(naive_device.begin(), naive_device.end(), t_host.begin()) &&
+                std::equal(t_device.begin(), t_device.end(), t_host.begin());
+    std::cout << (succeeded ? "Transpose succeeded.\n" : "Transpose failed.\n") << std::endl;
+}
+ 
+signed main(int argc, char *argv[]) {
+
+    // 通过命令行参数选择要运行的 kernel：naive / tiled / views / double / subgroup / blocked / tuned / half / bf16 / 
+    // strassen / fused / trans_a / trans_b；不指定时全部运行；cpu 参数使用 CPU 设备运行，例如 cpu naive tiled subgroup
+    // 形如 1000x777x500 的参数表示以运行时大小计算 c[1000][500] = a[1000][777] * b[777][500]（各维均大于 0）
+    // scaling 参数额外输出 host GEMM 随线程数的扩展情况；retune 参数忽略缓存重新调优 tile 形状
+    // batched 参数只运行批量 GEMM 基准；crossover 参数只运行 Strassen–Winograd 与 tiled kernel 的对比基准
+    // cutoff=N 设置 Strassen–Winograd 的截断大小（N > 0）；sparse 参数只运行稀疏矩阵（CSR / Sliced ELL）基准
+    // ooc 参数运行外存 GEMM（矩阵大小可由 MxNxP 参数指定），block=N 设置其分块边长（N > 0）
+    // multi 参数把 tiled kernel 按吞吐量分配到全部设备上并发运行（矩阵大小可由 MxNxP 参数指定）
+    // 默认以 Freivalds 算法随机验证结果，fp=P 设置误判概率上界（0 < P < 1，默认 1e-6）；
+    // full 参数改为在 host 上完整计算后逐元素比较
+    // int8 参数运行量化 GEMM（uint8 x int8，int32 累加）基准（矩阵大小可由 MxNxP 参数指定，N 不超过 32768）
+    // transpose 参数运行转置带宽基准（矩阵大小可由 MxNxP 参数的前两维指定）
+    // a=PATH b=PATH 从 .npy 或 raw 格式的文件加载 A、B 并以运行时大小计算；c=PATH 把 host 乘积保存到文件（.npy 或 raw）
+    options opts;
+    std::optional<std::array<int, 3>> shape;
+    for (int i = 1; i < argc; i++) {
+        std::array<int, 3> mnp;
+        std::string arg = argv[i];
+        if (std::sscanf(argv[i], "%dx%dx%d", &mnp[0], &mnp[1], &mnp[2]) == 3)
+            shape = mnp;
+        else if (arg == "scaling")
+            opts.host_scaling = true;
+        else if (arg == "batched")
+            opts.batched = true;
+        else if (arg == "crossover")
+            opts.crossover = true;
+        else if (arg == "sparse")
+            opts.sparse = true;
+        else if (arg == "cpu")
+            opts.cpu = true;
+        else if (arg == "ooc")
+            opts.out_of_core = true;
+        else if (arg == "multi")
+            opts.multi_device = true;
+        else if (arg == "transpose")
+            opts.transpose = true;
+        else if (arg == "int8")
+            opts.quantized = true;
+        else if (arg == "full")
+            opts.full_check = true;
+        else if (std::sscanf(argv[i], "fp=%lf", &opts.false_positive) == 1)
+            continue;
+        else if (std::sscanf(argv[i], "block=%zu", &opts.block) == 1)
+            continue;
+        else if (std::sscanf(argv[i], "cutoff=%zu", &opts.cutoff) == 1)
+            continue;
+        else if (arg.rfind("a=", 0) == 0)
+            opts.a_path = arg.substr(2);
+        else if (arg.rfind("b=", 0) == 0)
+            opts.b_path = arg.substr(2);
+        else if (arg.rfind("c=", 0) == 0)
+            opts.c_path = arg.substr(2);
+        else if (arg == "retune")
+            opts.retune = true, opts.kernels.push_back("tuned");
+        else opts.kernels.push_back(arg);
+    }
+    if (shape.has_value() && std::any_of(shape->begin(), shape->end(), [](int d) { return d <= 0; })) {
+        std::cout << "MxNxP requires M, N, P > 0.\n";
+        return 1;
+    }
+    if (opts.cutoff == 0) {
+        std::cout << "cutoff=N requires N > 0.\n";
+        return 1;
+    }
+    if (!(opts.false_positive > 0 && opts.false_positive < 1)) {
+        std::cout << "fp=P requires 0 < P < 1.\n";
+        return 1;
+    }
+    if (opts.block == 0) {
+        std::cout << "block=N requires N > 0.\n";
+        return 1;
+    }
+    if (opts.batched) {
+        batched_benchmark(batch_count, batch_matrix_size);
+        return 0;
+    }
+    if (opts.crossover) {
+        strassen_benchmark(opts.cutoff);
+        return 0;
+    }
+    if (opts.sparse) {
+        sparse_benchmark(sparse_matrix_size, sparse_columns);
+        return 0;
+    }
+    if (opts.multi_device) {
+        auto [m, n, p] = shape.value_or(std::array<int, 3>{M, N, P});
+        multiply_multi_device(m, n, p);
+        return 0;
     }
+    if (opts.quantized) {
+        auto [m, n, p] = shape.value_or(std::array<int, 3>{M, N, P});
+        quantized_benchmark(m, n, p);
+        return 0;
+    }
+    if (opts.transpose) {
+        auto [m, n, p] = shape.value_or(std::array<int, 3>{transpose_size, transpose_size, 0});
+        transpose_benchmark(m, n);
+        return 0;
+    }
+    if (opts.out_of_core) {
+        auto [m, n, p] = shape.value_or(std::array<int, 3>{out_of_core_size, out_of_core_size, out_of_core_size});
+        out_of_core_benchmark(m, n, p, opts.block);
+        return 0;
+    }
+    if (!opts.a_path.empty() || !opts.b_path.empty()) {
+        if (opts.a_path.empty() || opts.b_path.empty()) {
+            std::cout << "Both a=PATH and b=PATH are required.\n";
+            return 1;
+        }
+        multiply_files(opts);
+        return 0;
+    }
+    if (shape.has_value()) {
+        auto [m, n, p] = *shape;
+        multiply_dynamic(m, n, p, opts);
+        return 0;
+    }
+    const auto blocked_label = "Register blocked " + std::to_string(micro_tile_m) + "x" + std::to_string(micro_tile_n);
+
+    my::mat<float, M, N> a_host;
+    my::mat<float, N, P> b_host;
+    my::mat<float, M, P> c0;
+    a_host.random(), b_host.random(), c0.random();
+    std::vector<float> bias(P);
+    auto epilogue = make_example_epilogue(N, bias);
+    std::list<device_output<my::mat<float, M, P>>> outputs;
+
+    my::print_platforms();
+
+    try {
+        auto q = make_queue(opts);
+        std::cout << "Running on device: "
+                  << q.get_device().get_info<sycl::info::device::name>() << "\n";
+
+        std::cout << "Problem size: " << "c[" << M << "][" << P << "] = a[" 
+                  << M << "][" << N << "] * b[" << N << "][" << P << "]\n\n";
+        // hint: 容差需要读取 host 矩阵，在 use_host_ptr 的 buffer 包装它们之前计算
+        const auto half_tolerance = mixed_tolerance<sycl::half>(a_host, b_host);
+        const auto bf16_tolerance = mixed_tolerance<bfloat16>(a_host, b_host);
+        const auto strassen_tol = strassen_tolerance(a_host, b_host, opts.cutoff);
+        // hint: 预先存放 A^T、B^T，验证 op = t 时的 kernel 恰好把它们转置回来；转置同样读取 host 矩阵
+        std::optional<decltype(!a_host)> a_t;
+        std::optional<decltype(!b_host)> b_t;
+        if (opts.selected("trans_a") || opts.selected("trans_b"))
+            a_t = !a_host, b_t = !b_host;
+        // hint: C++17 的 lambda 不能捕获结构化绑定，这里用引用取出两个 buffer
+        auto operands = upload_operands(q, a_host, b_host);
+        auto &a_buf = operands.first, &b_buf = operands.second;
+
+        auto run = [&](const std::string &name, const std::string &label, auto &&kernel, float tolerance = 1e-4f,
+                       std::function<my::mat<float, M, P>(const my::mat<float, M, P> &)> expected = nullptr) {
+            if (!opts.selected(name)) return;
+            outputs.push_back({label, my::mat<float, M, P>(), tolerance, expected});
+            auto &c_out = outputs.back().c;
+            auto c_buf = c_out.buffer();
+            run_on_device(label, [&] { return kernel(c_buf); });
+        };
+
+        run("naive", "", [&](auto &c_buf) { return kernel(q, a_buf, b_buf, c_buf); });
+        run("tiled", "Tiled", [&](auto &c_buf) { return kernel2(q, a_buf, b_buf, c_buf); });
+        run("views", "Tiled, 2x2 block views", [&](auto &c_buf) { return blocked_views(q, a_buf, b_buf, c_buf); });
+        run("double", "Tiled, double-buffered", [&](auto &c_buf) { 
+            return kernel2_double_buffered(q, a_buf, b_buf, c_buf); 
+        });
+        run("subgroup", "Sub-group", [&](auto &c_buf) { return subgroup_gemm(q, a_buf, b_buf, c_buf); });
+        run("blocked", blocked_label, [&](auto &c_buf) { 
+            return kernel3<micro_tile_m, micro_tile_n>(q, a_buf, b_buf, c_buf); 
+        });
+        if (opts.selected("tuned")) {
+            auto &config = tuned_config(q, a_buf, b_buf, opts.retune);
+            run("tuned", "Tuned " + config.name, [&](auto &c_buf) { return config.run(q, a_buf, b_buf, c_buf); });
+        }
+
+        run("half", "Half inputs", [&](auto &c_buf) { 
+            return mixed_precision<sycl::half>(q, a_buf, b_buf, c_buf); 
+        }, half_tolerance);
+        run("bf16", "Bfloat16 inputs", [&](auto &c_buf) { 
+            return mixed_precision<bfloat16>(q, a_buf, b_buf, c_buf); 
+        }, bf16_tolerance);
+        run("strassen", "Strassen-Winograd, cutoff " + std::to_string(opts.cutoff), [&](auto &c_buf) {
+            return strassen(q, a_buf, b_buf, c_buf, opts.cutoff);
+        }, strassen_tol);
+        run_fused_variants(run, q, a_buf, b_buf, c0, epilogue);
+        if (a_t.has_value()) {
+            auto a_t_buf = a_t->buffer();
+            auto b_t_buf = b_t->buffer();
+            run("trans_a", "Tiled, op(A) = T", [&](auto &c_buf) {
+                return transposed_gemm<my::op::t, my::op::n>(q, a_t_buf, b_buf, c_buf);
+            });
+            run("trans_b", "Tiled, op(B) = T", [&](auto &c_buf) {
+                return transposed_gemm<my::op::n, my::op::t>(q, a_buf, b_t_buf, c_buf);
+            });
+        }
+
+    } catch (sycl::exception const &e) {
+        std::cout << "An exception is caught for matrix multiplication.\n";
+        std::terminate();
+    }
+
+    host_transposed(a_host, b_host, outputs, opts);
+    host_views(a_host, b_host, outputs, opts);
+    verify_outputs(a_host, b_host, outputs, opts);
     return 0;
-}
\ No newline at end of file
+}